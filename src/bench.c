@@ -0,0 +1,809 @@
+/*
+ * bench.c (last modified 2026-10-18)
+ * This is a benchmark for the kopForth inner interpreters. It builds a loop
+ * heavy word and times running it with kopForthTick and with kopForthRun.
+ * Build it once as-is and once with KF_DIRECT_THREADED to compare engines.
+ * It also times single words from kfWordsStackMem.h, so building it with and
+ * without KF_NATIVE_STACK_MEM compares the colon and native versions, and the
+ * double cell words, so building it with KF_MATH_BYTES compares math backends.
+ * Those words are checked against __int128 on random inputs before they're timed.
+ * Lastly it times FIND, which can be built with KF_HASHED_FIND, INTERPRET,
+ * starting clones of the benchmark system with kopForthClone, and starting a
+ * whole system from kopForthInit until QUIT first waits for input, which can be
+ * built with KF_PREBUILT_KERNEL.
+ * Parsing is timed on two large generated source files, one of ordinary code
+ * and one of long comments and whitespace, with the byte at a time scanner and
+ * the kfScan.h kernels taking turns, so it compares them in the same build.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Include the main kopForth header.
+#include "kopForth.h"
+
+
+
+// How many times the benchmark loop runs its body.
+#define BENCH_LOOPS 2000000
+// How many times each word is run in the per word benchmark.
+#define BENCH_OP_LOOPS 200000
+// How many times each of those loops is timed.
+#define BENCH_OP_RUNS 3
+// How many random inputs the double cell words are checked on.
+#define BENCH_CHECK_CASES 200000
+// How many words to define for the FIND benchmark.
+#define BENCH_FIND_WORDS 200
+// How many times each of those words is looked up.
+#define BENCH_FIND_LOOPS 500
+// How many times the INTERPRET benchmark interprets its line.
+#define BENCH_INTERPRET_LOOPS 20000
+// The lines that INTERPRET gets, they have to leave the stack empty.
+#define BENCH_INTERPRET_LINE "1 2 + DROP 3 DUP * DROP HERE BL 2DROP STATE @ 0= DROP"
+#define BENCH_NUMBER_LINE    "12345 -678 2DROP 99999. 2DROP 4096 -1 65535 2DROP DROP"
+// How many times a clone of the benchmark system is started.
+#define BENCH_CLONES 10000
+// How many lines the generated source file for the parsing benchmark has, and
+// the lines it repeats, which each leave the stack the way they found it.
+#define BENCH_SOURCE_LINES 100000
+// How many times the source gets split into names for each timing, and how
+// many timings each scanner gets. Looking the names up is slow enough without
+// KF_HASHED_FIND that it's only done once.
+#define BENCH_SOURCE_LOOPS 10
+#define BENCH_SOURCE_RUNS 5
+static const char* benchSourceLines[] = {
+    "\\ Stack words, with comments and indentation like a real source file\n",
+    "    ( Adds the squares of two numbers and drops the result again )\n",
+    "    3 4 DUP * SWAP DUP * + DROP   \\ 25\n",
+    "\t10 20 Over OVER 2drop 2DUP 2drop SWAP drop DROP HERE DROP\n",
+    "        base @ Drop state @ drop   ( -- )\n",
+    "1. 2DROP  depth DROP 7 3 - 4 = DROP $FF %101 2drop\r\n",
+};
+// Lines for a second source that's mostly long comments and long runs of
+// whitespace, where the scanners spend their time on spans instead of names.
+static const char* benchCommentLines[] = {
+    "\\ ==========================================================================================\n",
+    "( SUM-SQUARES takes two numbers off the stack and leaves the sum of their squares. It is "
+    "written out at length the way a library documents its words, so the comment is several "
+    "times longer than the code that goes with it. )\n",
+    "                                                                3 4 DUP * SWAP DUP * + DROP\n",
+    "\\ The words below are indented a long way, with tabs and spaces, to line them up with the "
+    "code they belong to.\n",
+    "\t\t\t\t\t\t\t\t                                                        1 2 2DROP\n",
+    "5 DROP                                                                                  "
+    "( -- ) \\ trailing comment after a run of spaces\r\n",
+};
+// How many times a new system is started for the startup benchmark.
+#define BENCH_STARTS 1000
+
+
+
+double benchNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+kfWord* benchFind(kopForth* forth, char* name) {
+    usize len = strlen(name);
+    for (kfWord* word = forth->latest; word != NULL; word = word->link) {
+        if (word->name_len == len && memcmp(word->name, name, len) == 0)
+            return word;
+    }
+    printf("Missing word: %s\n", name);
+    exit(1);
+}
+
+// Runs a thread that ends in BYE, either one kopForthTick at a time or through
+// kopForthRun, and stores the number of words run and the time it took.
+void benchExec(kopForth* forth, kfWord* runner, bool tick, usize* ticks_out,
+               double* elapsed_out) {
+    kfDataStackInit(&forth->d_stack);
+    kfRetnStackInit(&forth->r_stack);
+    forth->pc = (uint8_t*) runner;
+
+    kfStatus s;
+    usize ticks = 0;
+    double start = benchNow();
+    if (tick) {
+        do {
+            s = kopForthTick(forth);
+            ticks++;
+        } while (kfStatusIsOk(s));
+    } else {
+        usize n;
+        do {
+            s = kopForthRun(forth, 100000, &n);
+            ticks += n;
+        } while (kfStatusIsOk(s));
+    }
+    double elapsed = benchNow() - start;
+
+    if (s != KF_SYSTEM_DONE) {
+        printf("Error: %d (%s)\n", s, kfStatusStr[s]);
+        exit(s);
+    }
+    *ticks_out = ticks;
+    *elapsed_out = elapsed;
+}
+
+// Runs `word` to completion like benchExec.
+void benchTime(kopForth* forth, kfWord* word, bool tick, usize* ticks_out,
+               double* elapsed_out) {
+    // A tiny thread that runs the word and then BYE, so we know when it's done.
+    kfWord* runner = kopForthAddWord(forth, "(BENCH-RUN)");
+        WRD(word);
+        WRD(benchFind(forth, "BYE"));
+    benchExec(forth, runner, tick, ticks_out, elapsed_out);
+}
+
+// Runs `word` to completion and reports the number of words run and the time
+// it took.
+void benchRun(kopForth* forth, char* label, kfWord* word, bool tick) {
+    usize ticks;
+    double elapsed;
+    benchTime(forth, word, tick, &ticks, &elapsed);
+    printf("%-24s %12lu words %8.3f s %8.1f Mwords/s\n", label,
+           (unsigned long) ticks, elapsed, ticks / elapsed / 1e6);
+}
+
+// A word to time on its own, with the arguments it gets and how many results
+// it leaves.
+typedef struct {
+    char* name;
+    usize ins;
+    isize args[4];
+    usize outs;
+} benchOp;
+
+// Builds a loop that pushes `op`'s arguments, runs it (if `run` is set) and
+// drops what's left, then times it with kopForthRun. It's timed a few times
+// and the best one is kept, since the differences between these loops can be
+// smaller than the noise in any one of them.
+void benchOpTime(kopForth* forth, benchOp* op, bool run, usize* ticks,
+                 double* elapsed) {
+    kfWord* bra = forth->debug_words.bra;
+    kfWord* zbr = forth->debug_words.zbr;
+    kfWord* ext = forth->debug_words.ext;
+    kfWord* sub = benchFind(forth, "-");
+    kfWord* dup = benchFind(forth, "DUP");
+    kfWord* drp = benchFind(forth, "DROP");
+    kfWord* word = benchFind(forth, op->name);
+
+    // : (BENCH-OP) BENCH_OP_LOOPS BEGIN DUP WHILE args op drops 1 - REPEAT DROP ;
+    kfWord* loop = kopForthAddWord(forth, "(BENCH-OP)"); {
+        LIT(BENCH_OP_LOOPS);
+        WRDADDR(b00, dup); LITADDR(b01, zbr, 0);
+        for (usize i = 0; i < op->ins; i++) {
+            LIT(op->args[i]);
+        }
+        if (run) {
+            WRD(word);
+            for (usize i = 0; i < op->outs; i++) {
+                WRD(drp);
+            }
+        } else {
+            for (usize i = 0; i < op->ins; i++) {
+                WRD(drp);
+            }
+        }
+        LIT(1); WRD(sub);
+        WRD(bra); RAWADDR(b02, 0);
+        WRDADDR(b03, drp);
+        WRD(ext);
+        *b01 = (isize) b03;
+        *b02 = (isize) b00; }
+    kfWord* runner = kopForthAddWord(forth, "(BENCH-RUN)");
+        WRD(loop);
+        WRD(benchFind(forth, "BYE"));
+    for (usize i = 0; i < BENCH_OP_RUNS; i++) {
+        double t;
+        benchExec(forth, runner, false, ticks, &t);
+        if (i == 0 || t < *elapsed)
+            *elapsed = t;
+    }
+}
+
+// Times each word against a loop that only pushes and drops its arguments.
+// The word count is exact. The time is the difference between the two loops,
+// plus the DROPs the word saved, at what a word in the first loop costs next
+// to an empty one.
+void benchOps(kopForth* forth) {
+    // Scratch cell for `+!` to add into.
+    static isize cell;
+    benchOp ops[] = {
+        {"+",      2, {5, 3},           1},
+        {"OR",     2, {5, 3},           1},
+        {"AND",    2, {5, 3},           1},
+        {"XOR",    2, {5, 3},           1},
+        {"INVERT", 1, {5},              1},
+        {"OVER",   2, {5, 3},           3},
+        {"ROT",    3, {5, 3, 1},        3},
+        {"2DUP",   2, {5, 3},           4},
+        {"2DROP",  2, {5, 3},           0},
+        {"0=",     1, {5},              1},
+        {"<>",     2, {5, 3},           1},
+        {"<=",     2, {5, 3},           1},
+        {">",      2, {5, 3},           1},
+        {">=",     2, {5, 3},           1},
+        {"LSHIFT", 2, {5, 3},           1},
+        {"RSHIFT", 2, {5, 3},           1},
+        {"CELLS",  1, {5},              1},
+        {"+!",     2, {5, (isize) &cell}, 0},
+        {"D+",     4, {5, 0, 3, 0},     2},
+        {"M*/",    4, {5, 0, 3, 2},     2},
+        {"UM*",    2, {-5, 3},          2},
+        {"M*",     2, {-5, 3},          2},
+        {"UM/MOD", 3, {-5, 2, 3},       2},
+        {"SM/REM", 3, {-5, -1, 3},      2},
+        {"FM/MOD", 3, {-5, -1, 3},      2},
+        {"/",      2, {-5, 3},          1},
+        {"MOD",    2, {-5, 3},          1},
+        {"/MOD",   2, {-5, 3},          2},
+        {"*/",     3, {-5, 3, 2},       1},
+        {"*/MOD",  3, {-5, 3, 2},       2},
+        {"D-",     4, {5, 0, 3, 0},     2},
+        {"DNEGATE", 2, {5, 0},          2},
+        {"D<",     4, {5, 0, 3, 0},     1},
+        {"D=",     4, {5, 0, 3, 0},     1},
+        {"DABS",   2, {-5, -1},         2},
+        {"D2*",    2, {5, 0},           2},
+    };
+
+    benchOp none = {"DROP", 0, {0}, 0};
+    usize empty_ticks;
+    double empty_time;
+    benchOpTime(forth, &none, false, &empty_ticks, &empty_time);
+
+    printf("%-8s %12s %12s\n", "Word", "words/op", "ns/op");
+    for (usize i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+        usize base_ticks, op_ticks;
+        double base_time, op_time;
+        benchOpTime(forth, &ops[i], false, &base_ticks, &base_time);
+        benchOpTime(forth, &ops[i], true, &op_ticks, &op_time);
+        // The base loop drops every argument, while the word's loop only drops
+        // its results, so add the difference back in.
+        double saved = (double) ops[i].ins - ops[i].outs;
+        double word_time = (base_time - empty_time) / (base_ticks - empty_ticks);
+        double words = ((double) op_ticks - base_ticks) / BENCH_OP_LOOPS + saved;
+        double ns = (op_time - base_time + saved * word_time * BENCH_OP_LOOPS)
+                    / BENCH_OP_LOOPS * 1e9;
+        // Anything at or below 0 is lost in the noise, so say that rather than
+        // print a time the word doesn't really take.
+        if (ns > 0)
+            printf("%-8s %12.1f %12.2f\n", ops[i].name, words, ns);
+        else
+            printf("%-8s %12.1f %12s\n", ops[i].name, words, "<noise");
+    }
+}
+
+#if defined(__SIZEOF_INT128__) && UINTPTR_MAX == UINT64_MAX
+typedef __int128 benchWide;
+typedef unsigned __int128 benchUWide;
+
+// A random cell, biased toward the small, extreme and power of two values
+// where sign and carry handling tends to go wrong.
+isize benchRandom() {
+    static uint64_t state = 88172645463325252ull;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    uint64_t r = state;
+    switch (r & 7) {
+        case 0:  return (isize) (r >> 3) % 200 - 100;
+        case 1:  return (isize) ((uint64_t) 1 << (r >> 3) % 64) - ((r >> 9) & 1);
+        case 2:  return (r >> 3) & 1 ? INT64_MAX : INT64_MIN;
+        case 3:  return (isize) (r >> 3) % 2000000 - 1000000;
+        default: return (isize) r;
+    }
+}
+
+benchWide benchDouble(isize* low) {
+    return (benchWide) (benchUWide) (uint64_t) low[0] |
+           (benchWide) ((benchUWide) (uint64_t) low[1] << 64);
+}
+
+// Runs the word on `args` and checks that it leaves `expect`.
+void benchCheckWord(kopForth* forth, char* name, isize* args, usize ins,
+                    isize* expect, usize outs) {
+    kfDataStackInit(&forth->d_stack);
+    for (usize i = 0; i < ins; i++)
+        kfDataStackPush(&forth->d_stack, args[i]);
+    kfStatus s = benchFind(forth, name)->word_def.native(forth);
+    bool ok = kfStatusIsOk(s) && kfDataStackDepth(&forth->d_stack) == (isize) outs;
+    for (usize i = outs; ok && i > 0; i--) {
+        isize result = 0;
+        kfDataStackPop(&forth->d_stack, &result);
+        ok = result == expect[i - 1];
+    }
+    if (!ok) {
+        printf("Error: %s gave the wrong result for", name);
+        for (usize i = 0; i < ins; i++)
+            printf(" %ld", (long) args[i]);
+        printf("\n");
+        exit(1);
+    }
+}
+
+// Interprets `text` with kopForthEvaluate and checks that it leaves `expect`.
+void benchCheckEval(kopForth* forth, char* text, isize* expect, usize outs) {
+    kfDataStackInit(&forth->d_stack);
+    kfStatus s = kopForthEvaluate(forth, text, strlen(text));
+    bool ok = kfStatusIsOk(s) && kfDataStackDepth(&forth->d_stack) == (isize) outs;
+    for (usize i = outs; ok && i > 0; i--) {
+        isize result = 0;
+        kfDataStackPop(&forth->d_stack, &result);
+        ok = result == expect[i - 1];
+    }
+    if (!ok) {
+        printf("Error: \"%s\" gave the wrong result\n", text);
+        exit(1);
+    }
+}
+
+// Checks the shifts at and past the cell width, where the colon versions used
+// to differ from the native ones.
+void benchCheckShifts(kopForth* forth) {
+    isize out[3] = {0, 0, 0};
+    benchCheckEval(forth, "1 64 LSHIFT 1 64 RSHIFT -1 70 RSHIFT", out, 3);
+    benchCheckEval(forth, "-1 -1 LSHIFT -1 -1 RSHIFT 1 1000 LSHIFT", out, 3);
+    out[0] = (isize) 1 << 63; out[1] = 1; out[2] = 1;
+    benchCheckEval(forth, "1 63 LSHIFT -1 63 RSHIFT 1 0 RSHIFT", out, 3);
+    kfDataStackInit(&forth->d_stack);
+    printf("Shift words: match at and past the cell width\n");
+}
+
+// Checks that kopForthEvaluate puts the system back after text that aborts
+// partway through a definition, so the next text is interpreted and the data
+// stack it was called with is still there.
+void benchCheckEvalAbort(kopForth* forth) {
+    char* text = ": (BENCH-ABORT) 1 (BENCH-NOT-A-WORD) ;";
+    kfDataStackInit(&forth->d_stack);
+    kfDataStackPush(&forth->d_stack, 7);
+    kfStatus s = kopForthEvaluate(forth, text, strlen(text));
+    kfBiosFlush();
+    isize top = 0;
+    kfDataStackPop(&forth->d_stack, &top);
+    if (s != KF_SYSTEM_ABORTED || forth->state || top != 7 ||
+        kfDataStackDepth(&forth->d_stack) != 0) {
+        printf("Error: \"%s\" didn't leave the system as it was\n", text);
+        exit(1);
+    }
+    isize out[1] = {3};
+    benchCheckEval(forth, "1 2 +", out, 1);
+
+    // With room for only one more cell, text and len don't both fit.
+    kfDataStackInit(&forth->d_stack);
+    for (usize i = 0; i < KF_DATA_STACK_SIZE - 1; i++)
+        kfDataStackPush(&forth->d_stack, i);
+    kfWord* host = forth->host;
+    s = kopForthEvaluate(forth, "1", 1);
+    if (s != KF_DATA_STACK_OVERFLOW || forth->host != host ||
+        kfDataStackDepth(&forth->d_stack) != KF_DATA_STACK_SIZE - 1) {
+        printf("Error: EVALUATE on a full stack didn't leave the system as it was\n");
+        exit(1);
+    }
+    kfDataStackInit(&forth->d_stack);
+    printf("EVALUATE: an abort or a full stack leaves the system as it was\n");
+}
+
+// Checks the double cell and mixed precision words against __int128 on random
+// inputs. Inputs whose quotient doesn't fit in a cell are skipped, since only
+// the in range results are defined.
+void benchCheckMath(kopForth* forth) {
+    for (usize i = 0; i < BENCH_CHECK_CASES; i++) {
+        isize a = benchRandom(), b = benchRandom(), c = benchRandom();
+        isize d[4] = {a, b, c, benchRandom()};
+        benchWide d1 = benchDouble(d), d2 = benchDouble(d + 2);
+        benchWide r, q;
+        isize out[2];
+
+        benchUWide ur = (benchUWide) (uint64_t) a * (uint64_t) b;
+        out[0] = (isize) ur; out[1] = (isize) (ur >> 64);
+        benchCheckWord(forth, "UM*", d, 2, out, 2);
+        r = (benchWide) a * b;
+        out[0] = (isize) r; out[1] = (isize) (r >> 64);
+        benchCheckWord(forth, "M*", d, 2, out, 2);
+
+        r = d1 - d2;
+        out[0] = (isize) r; out[1] = (isize) (r >> 64);
+        benchCheckWord(forth, "D-", d, 4, out, 2);
+        r = d1 + d2;
+        out[0] = (isize) r; out[1] = (isize) (r >> 64);
+        benchCheckWord(forth, "D+", d, 4, out, 2);
+        r = (benchWide) (0 - (benchUWide) d1);
+        out[0] = (isize) r; out[1] = (isize) (r >> 64);
+        benchCheckWord(forth, "DNEGATE", d, 2, out, 2);
+        r = d1 < 0 ? (benchWide) (0 - (benchUWide) d1) : d1;
+        out[0] = (isize) r; out[1] = (isize) (r >> 64);
+        benchCheckWord(forth, "DABS", d, 2, out, 2);
+        r = (benchWide) ((benchUWide) d1 << 1);
+        out[0] = (isize) r; out[1] = (isize) (r >> 64);
+        benchCheckWord(forth, "D2*", d, 2, out, 2);
+        out[0] = d1 < d2 ? -1 : 0;
+        benchCheckWord(forth, "D<", d, 4, out, 1);
+        out[0] = d1 == d2 ? -1 : 0;
+        benchCheckWord(forth, "D=", d, 4, out, 1);
+        isize same[4] = {a, b, a, b};
+        out[0] = -1;
+        benchCheckWord(forth, "D=", same, 4, out, 1);
+
+        if (c == 0)
+            continue;
+        isize div[3] = {a, b, c};
+        benchUWide ud = (benchUWide) d1;
+        if (ud / (uint64_t) c <= UINT64_MAX) {
+            out[0] = (isize) (ud % (uint64_t) c); out[1] = (isize) (ud / (uint64_t) c);
+            benchCheckWord(forth, "UM/MOD", div, 3, out, 2);
+        }
+        q = d1 / c;
+        r = d1 % c;
+        if (d1 != (benchWide) ((benchUWide) 1 << 127) && q >= INT64_MIN && q <= INT64_MAX) {
+            out[0] = (isize) r; out[1] = (isize) q;
+            benchCheckWord(forth, "SM/REM", div, 3, out, 2);
+        }
+        if (r != 0 && (r < 0) != (c < 0)) {
+            q -= 1;
+            r += c;
+        }
+        if (d1 != (benchWide) ((benchUWide) 1 << 127) && q >= INT64_MIN && q <= INT64_MAX) {
+            out[0] = (isize) r; out[1] = (isize) q;
+            benchCheckWord(forth, "FM/MOD", div, 3, out, 2);
+        }
+
+        isize single[2] = {a, c};
+        q = (benchWide) a / c;
+        r = (benchWide) a % c;
+        if (q <= INT64_MAX) {
+            out[0] = (isize) q;
+            benchCheckWord(forth, "/", single, 2, out, 1);
+            out[0] = (isize) r;
+            benchCheckWord(forth, "MOD", single, 2, out, 1);
+            out[0] = (isize) r; out[1] = (isize) q;
+            benchCheckWord(forth, "/MOD", single, 2, out, 2);
+        }
+        q = (benchWide) a * b / c;
+        r = (benchWide) a * b % c;
+        if (q >= INT64_MIN && q <= INT64_MAX) {
+            out[0] = (isize) q;
+            benchCheckWord(forth, "*/", div, 3, out, 1);
+            out[0] = (isize) r; out[1] = (isize) q;
+            benchCheckWord(forth, "*/MOD", div, 3, out, 2);
+        }
+    }
+    kfDataStackInit(&forth->d_stack);
+    printf("Math words: %d random cases match __int128\n", BENCH_CHECK_CASES);
+}
+#else
+void benchCheckMath(kopForth* forth) {
+    printf("Math words: not checked, no __int128 to compare with\n");
+}
+#endif
+
+// Defines a batch of words and times looking each of them up with FIND, like
+// interpreting code that uses a large vocabulary does.
+void benchLookup(kopForth* forth) {
+    static uint8_t names[BENCH_FIND_WORDS][KF_MAX_NAME_SIZE];
+    for (usize i = 0; i < BENCH_FIND_WORDS; i++) {
+        char name[KF_MAX_NAME_SIZE];
+        snprintf(name, sizeof(name), "(BENCH-%lu)", (unsigned long) i);
+        kopForthAddWord(forth, name);
+            WRD(forth->debug_words.ext);
+        names[i][0] = strlen(name);
+        memcpy(&names[i][1], name, names[i][0]);
+    }
+    forth->latest = forth->pending;
+
+    kfNativeFunc find = benchFind(forth, "FIND")->word_def.native;
+    kfDataStackInit(&forth->d_stack);
+    isize found = 0;
+    double start = benchNow();
+    for (usize loop = 0; loop < BENCH_FIND_LOOPS; loop++) {
+        for (usize i = 0; i < BENCH_FIND_WORDS; i++) {
+            isize flag = 0, xt = 0;
+            kfDataStackPush(&forth->d_stack, (isize) names[i]);
+            find(forth);
+            kfDataStackPop(&forth->d_stack, &flag);
+            kfDataStackPop(&forth->d_stack, &xt);
+            found += flag != 0;
+        }
+    }
+    double elapsed = benchNow() - start;
+
+    usize lookups = BENCH_FIND_LOOPS * BENCH_FIND_WORDS;
+    if ((usize) found != lookups) {
+        printf("Error: FIND missed %lu words\n", (unsigned long) (lookups - found));
+        exit(1);
+    }
+    printf("%-24s %12lu finds %8.3f s %8.1f ns/find\n", "FIND",
+           (unsigned long) lookups, elapsed, elapsed / lookups * 1e9);
+}
+
+// Interprets a line over and over and reports the words run per line. This
+// is mostly the cost of INTERPRET and the words it calls for every token.
+void benchInterpret(kopForth* forth, char* label, char* line) {
+    kfWord* runner = kopForthAddWord(forth, "(BENCH-INTERP)");
+        WRD(benchFind(forth, "INTERPRET"));
+        WRD(benchFind(forth, "BYE"));
+    usize len = strlen(line);
+    usize ticks = 0;
+    double elapsed = 0;
+    for (usize i = 0; i < BENCH_INTERPRET_LOOPS; i++) {
+        usize n;
+        double t;
+        memcpy(forth->tib, line, len);
+        forth->tib_len = len;
+        forth->source = forth->tib;
+        forth->source_len = len;
+        forth->in_offset = 0;
+        benchExec(forth, runner, false, &n, &t);
+        ticks += n;
+        elapsed += t;
+    }
+    printf("%-24s %12.1f words/line %8.3f s %8.1f ns/line\n", label,
+           (double) ticks / BENCH_INTERPRET_LOOPS, elapsed,
+           elapsed / BENCH_INTERPRET_LOOPS * 1e9);
+}
+
+// Which kernels kfScan.h was built with.
+#if defined(KF_SCAN_AVX2)
+    #define BENCH_SCAN "avx2"
+#elif defined(KF_SCAN_SSE2)
+    #define BENCH_SCAN "sse2"
+#else
+    #define BENCH_SCAN "bytes"
+#endif
+
+// Splits `len` bytes of source into names the way PARSE-NAME does, skipping
+// comments, and returns how many names there were. With `find` each one is
+// also looked up like INTERPRET would, and the ones that aren't words (the
+// numbers) are counted in `misses`.
+usize benchTokens(kopForth* forth, uint8_t* text, usize len, bool scalar, bool find,
+                  usize* misses) {
+    uint8_t* end = text + len;
+    usize tokens = 0;
+    *misses = 0;
+    for (uint8_t* p = text; p < end;) {
+        uint8_t* start = scalar ? kfScanSkipScalar(p, end, ' ') : kfScanSkip(p, end, ' ');
+        if (start == end)
+            break;
+        uint8_t* stop = scalar ? kfScanUntilScalar(start, end, ' ') : kfScanUntil(start, end, ' ');
+        tokens++;
+        if (find && kfFindName(forth, start, stop - start) == NULL)
+            (*misses)++;
+        // Comments are skipped the way ( and \ do.
+        if (stop - start == 1 && (*start == '(' || *start == '\\')) {
+            isize delim = *start == '(' ? ')' : '\n';
+            p = stop < end ? stop + 1 : stop;
+            stop = scalar ? kfScanUntilScalar(p, end, delim) : kfScanUntil(p, end, delim);
+        }
+        p = stop < end ? stop + 1 : stop;
+    }
+    return tokens;
+}
+
+// Splits the source into names `loops` times and returns how long it took.
+double benchTokensTime(kopForth* forth, uint8_t* text, usize len, bool scalar,
+                       bool find, usize loops, usize* tokens) {
+    usize misses;
+    *tokens = 0;
+    double start = benchNow();
+    for (usize i = 0; i < loops; i++)
+        *tokens += benchTokens(forth, text, len, scalar, find, &misses);
+    return benchNow() - start;
+}
+
+void benchTokensPrint(char* label, usize tokens, double elapsed, double bytes) {
+    printf("%-24s %12lu tokens %7.3f s %8.1f Mtokens/s %7.0f MB/s\n", label,
+           (unsigned long) tokens, elapsed, tokens / elapsed / 1e6, bytes / elapsed / 1e6);
+}
+
+// Generates a large source file out of `lines` and times splitting it into
+// names with the byte at a time scanner and with the one kfScan.h was built
+// with, then with each name looked up, then interpreting the whole thing with
+// kopForthEvaluate.
+void benchSource(kopForth* forth, char* name, const char** lines, usize count) {
+    usize len = 0;
+    for (usize i = 0; i < BENCH_SOURCE_LINES; i++)
+        len += strlen(lines[i % count]);
+    char* text = malloc(len);
+    if (text == NULL) {
+        printf("Error: can't allocate the source\n");
+        exit(1);
+    }
+    char* p = text;
+    for (usize i = 0; i < BENCH_SOURCE_LINES; i++) {
+        usize n = strlen(lines[i % count]);
+        memcpy(p, lines[i % count], n);
+        p += n;
+    }
+
+    printf("Source, %s: %lu lines, %lu bytes\n", name,
+           (unsigned long) BENCH_SOURCE_LINES, (unsigned long) len);
+    // The two scanners take turns and each keeps its best time, so neither one
+    // gains from running first or loses to a burst of noise.
+    double best[2] = {0, 0};
+    usize tokens = 0;
+    for (usize run = 0; run < BENCH_SOURCE_RUNS; run++) {
+        for (usize scalar = 0; scalar < 2; scalar++) {
+            double elapsed = benchTokensTime(forth, (uint8_t*) text, len, scalar, false,
+                                             BENCH_SOURCE_LOOPS, &tokens);
+            if (run == 0 || elapsed < best[scalar])
+                best[scalar] = elapsed;
+        }
+    }
+    double bytes = (double) len * BENCH_SOURCE_LOOPS;
+    benchTokensPrint("PARSE-NAME bytes", tokens, best[1], bytes);
+    benchTokensPrint("PARSE-NAME " BENCH_SCAN, tokens, best[0], bytes);
+    double elapsed = benchTokensTime(forth, (uint8_t*) text, len, false, true, 1, &tokens);
+    benchTokensPrint("PARSE-NAME FIND-NAME", tokens, elapsed, len);
+
+    kfDataStackInit(&forth->d_stack);
+    double start = benchNow();
+    kfStatus s = kopForthEvaluate(forth, text, len);
+    elapsed = benchNow() - start;
+    if (!kfStatusIsOk(s) || kfDataStackDepth(&forth->d_stack) != 0) {
+        printf("Error: %d (%s)\n", s, kfStatusStr[s]);
+        exit(1);
+    }
+    benchTokensPrint("EVALUATE", tokens, elapsed, len);
+    free(text);
+}
+
+// Times starting and freeing clones of `forth`, then checks that one can run
+// the INTERPRET benchmark without touching `forth`.
+void benchClone(kopForth* forth) {
+    kopForth* clone = malloc(sizeof(kopForth));
+    double start = benchNow();
+    for (usize i = 0; i < BENCH_CLONES; i++) {
+        kfStatus s = kopForthClone(forth, clone);
+        if (!kfStatusIsOk(s)) {
+            printf("Error: %d (%s)\n", s, kfStatusStr[s]);
+            exit(s);
+        }
+        if (i + 1 < BENCH_CLONES)
+            kopForthFree(clone);
+    }
+    double elapsed = benchNow() - start;
+    printf("%-24s %12d clones %7.3f s %8.1f ns/clone\n", "kopForthClone",
+           BENCH_CLONES, elapsed, elapsed / BENCH_CLONES * 1e9);
+
+    uint8_t* here = forth->here;
+    benchInterpret(clone, "INTERPRET clone", BENCH_INTERPRET_LINE);
+    if (forth->here != here) {
+        printf("Error: the clone changed its parent\n");
+        exit(1);
+    }
+    kopForthFree(clone);
+    free(clone);
+}
+
+// Times kopForthInit and then running the new system until QUIT gets to its
+// first REFILL, which is where it would wait for the first line of input.
+void benchStartup() {
+    kopForth* forth = malloc(sizeof(kopForth));
+    double init_time = 0;
+    double prompt_time = 0;
+    usize ticks = 0;
+    usize committed = 0;
+    for (usize i = 0; i < BENCH_STARTS; i++) {
+        double start = benchNow();
+        kfStatus s = kopForthInit(forth);
+        double init = benchNow();
+        if (!kfStatusIsOk(s)) {
+            printf("Error: %d (%s)\n", s, kfStatusStr[s]);
+            exit(s);
+        }
+        // Looked up outside of the timing, the system doesn't need to.
+        kfWord* refill = benchFind(forth, "REFILL");
+        init_time += init - start;
+
+        start = benchNow();
+        while ((kfWord*) forth->pc != refill) {
+            s = kopForthTick(forth);
+            if (!kfStatusIsOk(s)) {
+                printf("Error: %d (%s)\n", s, kfStatusStr[s]);
+                exit(s);
+            }
+            ticks++;
+        }
+        prompt_time += benchNow() - start;
+        committed = forth->mem_committed;
+        kopForthFree(forth);
+    }
+    printf("%-24s %12d starts %9.2f us init %6.2f us to prompt %6.1f words\n",
+           "kopForthInit", BENCH_STARTS, init_time / BENCH_STARTS * 1e6,
+           prompt_time / BENCH_STARTS * 1e6, (double) ticks / BENCH_STARTS);
+    printf("%-24s %12d bytes committed\n", "", (int) committed);
+    free(forth);
+}
+
+int main() {
+    kfBiosSetup();
+    kfStatus s = kopForthTest();
+    kfBiosFlush();
+    if (!kfStatusIsOk(s)) {
+        printf("Error: %d (%s)\n", s, kfStatusStr[s]);
+        return s;
+    }
+    kopForth* forth = malloc(sizeof(kopForth));
+    s = kopForthInit(forth);
+    if (!kfStatusIsOk(s)) {
+        printf("Error: %d (%s)\n", s, kfStatusStr[s]);
+        return s;
+    }
+
+    kfWord* bra = forth->debug_words.bra;
+    kfWord* zbr = forth->debug_words.zbr;
+    kfWord* ext = forth->debug_words.ext;
+    kfWord* sub = benchFind(forth, "-");
+    kfWord* mul = benchFind(forth, "*");
+    kfWord* dup = benchFind(forth, "DUP");
+    kfWord* drp = benchFind(forth, "DROP");
+    kfWord* ovr = benchFind(forth, "OVER");
+    kfWord* add = benchFind(forth, "+");
+
+    // : (BENCH-LOOP) ( n -- ) BEGIN DUP WHILE DUP 3 * OVER + DROP 1 - REPEAT DROP ;
+    kfWord* loop = kopForthAddWord(forth, "(BENCH-LOOP)"); {
+        WRDADDR(b00, dup); LITADDR(b01, zbr, 0);
+        WRD(dup); LIT(3); WRD(mul); WRD(ovr); WRD(add); WRD(drp);
+        LIT(1); WRD(sub);
+        WRD(bra); RAWADDR(b02, 0);
+        WRDADDR(b03, drp);
+        WRD(ext);
+        *b01 = (isize) b03;
+        *b02 = (isize) b00; }
+    // : (BENCH) BENCH_LOOPS (BENCH-LOOP) ;
+    kfWord* bench = kopForthAddWord(forth, "(BENCH)");
+        LIT(BENCH_LOOPS); WRD(loop);
+        WRD(ext);
+
+    #ifdef KF_DIRECT_THREADED
+        printf("Engine: direct-threaded\n");
+    #else
+        printf("Engine: classic\n");
+    #endif
+    #ifdef KF_NATIVE_STACK_MEM
+        printf("Stack/memory words: native\n");
+    #else
+        printf("Stack/memory words: colon\n");
+    #endif
+    benchRun(forth, "kopForthTick", bench, true);
+    benchRun(forth, "kopForthRun", bench, false);
+    printf("\n");
+    benchCheckMath(forth);
+    benchCheckShifts(forth);
+    benchCheckEvalAbort(forth);
+    benchOps(forth);
+    printf("\n");
+    #ifdef KF_HASHED_FIND
+        printf("Dictionary lookup: hashed\n");
+    #else
+        printf("Dictionary lookup: linear\n");
+    #endif
+    benchLookup(forth);
+    benchInterpret(forth, "INTERPRET", BENCH_INTERPRET_LINE);
+    benchInterpret(forth, "INTERPRET numbers", BENCH_NUMBER_LINE);
+    printf("\n");
+    printf("Scan kernels: %s\n", BENCH_SCAN);
+    benchSource(forth, "code", benchSourceLines,
+                sizeof(benchSourceLines) / sizeof(benchSourceLines[0]));
+    benchSource(forth, "comments", benchCommentLines,
+                sizeof(benchCommentLines) / sizeof(benchCommentLines[0]));
+    printf("\n");
+    benchClone(forth);
+    printf("\n");
+    #ifdef KF_PREBUILT_KERNEL
+        printf("Kernel: prebuilt\n");
+    #else
+        printf("Kernel: built at startup\n");
+    #endif
+    benchStartup();
+
+    kfBiosTeardown();
+    kopForthFree(forth);
+    free(forth);
+    return 0;
+}
@@ -2,7 +2,7 @@
 #define KF_BIOS_H
 
 /*
- * kfBios.h (last modified 2025-06-12)
+ * kfBios.h (last modified 2026-10-17)
  * The BIOS file is meant to hold all the constants and interface functions
  * needed for easily porting kopForth to other platforms.
  * In theory, this should be the only file that needs to change for porting.
@@ -20,12 +20,19 @@
 #if defined(KF_IS_WINDOWS)
     // Windows requires this for the getch() function.
     #include <conio.h>
+    #include <io.h>
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
 #endif
 
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 
 
 
@@ -42,13 +49,36 @@ typedef intptr_t isize;
 // How many items to allocate for the data stack.
 #define KF_DATA_STACK_SIZE 64
 // How many items to allocate for the return stack.
-#define KF_RETN_STACK_SIZE 32
-// How many bytes to allocate for the terminal input buffer.
-#define KF_TIB_SIZE 80
-// How many bytes to allocate for the working memory (plus word definitions).
-#define KF_MEM_SIZE 4096*sizeof(void*)
+#define KF_RETN_STACK_SIZE 64
+// How many bytes to allocate for the terminal input buffer, which is the
+// longest line that can be typed in.
+#define KF_TIB_SIZE 4096
+// How many bytes of memory for word definitions (and data) kopForthInit
+// reserves. kopForthInitSized can reserve any other amount.
+#define KF_MEM_SIZE (4096 * sizeof(void*))
+// How many bytes of memory get committed at a time as the dictionary grows.
+#define KF_MEM_COMMIT_SIZE 16384
+// How many bytes past HERE are kept committed, since WORD and PAD use the
+// memory after HERE without allotting it.
+#define KF_MEM_HEADROOM 1024
+// How many bytes of output are buffered before they're written.
+#define KF_OUT_SIZE 4096
+// How many bytes of input are buffered in batch mode, which is the longest line
+// that can be piped in.
+#define KF_IN_SIZE (256 * 1024)
 // How many bytes to allocate for the names of words (including \0).
 #define KF_MAX_NAME_SIZE 16
+// How many slots to allocate for the FIND hash index (must be a power of 2).
+#define KF_FIND_HASH_SIZE 1024
+// How many cells a colon word's body can be for the compiler to inline it.
+#define KF_INLINE_SIZE 6
+// How many bytes a file name can be (including \0).
+#define KF_PATH_SIZE 256
+// How many input sources (included files and EVALUATEd strings) can be nested
+// inside each other.
+#define KF_SOURCE_DEPTH 8
+// How many included file names REQUIRED remembers.
+#define KF_INCLUDED_SIZE 64
 // The character to use for return (keyboard input).
 #ifdef KF_IS_WINDOWS
     // In Windows, the getch() function returns '\r' on keyboard return.
@@ -61,23 +91,111 @@ typedef intptr_t isize;
 
 
 
-void kfBiosPrintIsize(isize value) {
-    printf("%" PRIdPTR, value);
-}
+// Output is collected in kfBiosOut and written in one go when it's flushed.
+// It gets flushed when it's full, before reading input, and by kfBiosTeardown
+// and BYE, and after every newline if stdout is a terminal so that a user sees
+// each line as soon as it's done.
+static char kfBiosOut[KF_OUT_SIZE];
+static usize kfBiosOutLen = 0;
+static bool kfBiosOutInteractive = true;
 
-void kfBiosPrintPointer(void* value) {
-    printf("%p", value);
+void kfBiosFlush() {
+    if (kfBiosOutLen > 0) {
+        fwrite(kfBiosOut, 1, kfBiosOutLen, stdout);
+        kfBiosOutLen = 0;
+    }
 }
 
 void kfBiosWriteChar(isize value) {
-    printf("%c", (int) value);
+    if (kfBiosOutLen == KF_OUT_SIZE)
+        kfBiosFlush();
+    kfBiosOut[kfBiosOutLen++] = (char) value;
+    if (value == KF_NL && kfBiosOutInteractive)
+        kfBiosFlush();
+}
+
+void kfBiosWriteStrLen(char* value, usize len) {
+    if (len > KF_OUT_SIZE - kfBiosOutLen)
+        kfBiosFlush();
+    if (len >= KF_OUT_SIZE) {
+        // Too big to be worth copying, so write it straight out.
+        fwrite(value, 1, len, stdout);
+        return;
+    }
+    memcpy(kfBiosOut + kfBiosOutLen, value, len);
+    kfBiosOutLen += len;
+    if (kfBiosOutInteractive && memchr(value, KF_NL, len) != NULL)
+        kfBiosFlush();
+}
+
+void kfBiosWriteStr(char* value) {
+    kfBiosWriteStrLen(value, strlen(value));
+}
+
+void kfBiosPrintIsize(isize value) {
+    char str[32];
+    int len = snprintf(str, sizeof(str), "%" PRIdPTR, value);
+    kfBiosWriteStrLen(str, len);
+}
+
+void kfBiosPrintPointer(void* value) {
+    char str[32];
+    int len = snprintf(str, sizeof(str), "%p", value);
+    kfBiosWriteStrLen(str, len);
 }
 
 void kfBiosCR() {
     kfBiosWriteChar(KF_NL);
 }
 
+// Input is read a line at a time in batch mode, which is used when stdin isn't
+// a terminal or when built with KF_BATCH_INPUT. kfBiosIn holds the input that
+// hasn't been used yet, from kfBiosInStart to kfBiosInEnd. When it runs out
+// before the end of a line, the unused tail is moved to the front and as much
+// input as is ready is read in after it, so a line can be up to KF_IN_SIZE
+// long and is always in one piece. REFILL parses lines right out of it, and
+// nothing is echoed or edited.
+static char kfBiosIn[KF_IN_SIZE];
+static usize kfBiosInStart = 0;
+static usize kfBiosInEnd = 0;
+static bool kfBiosInSkip = false;
+static bool kfBiosInBatch = false;
+
+bool kfBiosIsBatch() {
+    return kfBiosInBatch;
+}
+
+// Moves the unused input to the front of kfBiosIn and reads more after it.
+// Returns false at the end of input, or if kfBiosIn is already full.
+bool kfBiosInFill() {
+    usize used = kfBiosInEnd - kfBiosInStart;
+    if (kfBiosInStart > 0) {
+        memmove(kfBiosIn, kfBiosIn + kfBiosInStart, used);
+        kfBiosInStart = 0;
+        kfBiosInEnd = used;
+    }
+    if (kfBiosInEnd == KF_IN_SIZE)
+        return false;
+    #ifdef KF_IS_WINDOWS
+        int n = _read(_fileno(stdin), kfBiosIn + kfBiosInEnd, KF_IN_SIZE - kfBiosInEnd);
+    #else
+        ssize_t n = read(STDIN_FILENO, kfBiosIn + kfBiosInEnd, KF_IN_SIZE - kfBiosInEnd);
+    #endif
+    if (n <= 0)
+        return false;
+    kfBiosInEnd += n;
+    return true;
+}
+
+// Returns the next character of input, or -1 at the end of input.
 isize kfBiosReadChar() {
+    // Make sure whatever asked for the input has been seen first.
+    kfBiosFlush();
+    if (kfBiosInBatch) {
+        if (kfBiosInStart == kfBiosInEnd && !kfBiosInFill())
+            return -1;
+        return (uint8_t) kfBiosIn[kfBiosInStart++];
+    }
     #ifdef KF_IS_WINDOWS
         // We use getch() on Windows to get around the input buffering issue.
         return getch();
@@ -86,25 +204,169 @@ isize kfBiosReadChar() {
     #endif
 }
 
-void kfBiosWriteStr(char* value) {
-    while (*value) {
-        kfBiosWriteChar(*value);
-        value++;
+// Finds the next line of batch input, without the line ending, and points
+// `line` at it. It stays valid until input is read again. A line longer than
+// KF_IN_SIZE gets cut off there and the rest of it is skipped. Returns the
+// length of the line, or -1 at the end of input.
+isize kfBiosReadLine(char** line) {
+    kfBiosFlush();
+    // Skip what's left of a line that was cut off.
+    while (kfBiosInSkip) {
+        char* nl = memchr(kfBiosIn + kfBiosInStart, '\n', kfBiosInEnd - kfBiosInStart);
+        if (nl != NULL) {
+            kfBiosInStart = nl + 1 - kfBiosIn;
+            kfBiosInSkip = false;
+        } else {
+            kfBiosInStart = kfBiosInEnd;
+            if (!kfBiosInFill())
+                return -1;
+        }
+    }
+    usize scan = kfBiosInStart;
+    usize len;
+    while (true) {
+        char* nl = memchr(kfBiosIn + scan, '\n', kfBiosInEnd - scan);
+        if (nl != NULL) {
+            len = nl - (kfBiosIn + kfBiosInStart);
+            *line = kfBiosIn + kfBiosInStart;
+            kfBiosInStart += len + 1;
+            break;
+        }
+        // Only the new input needs to be searched for the end of the line.
+        scan = kfBiosInEnd - kfBiosInStart;
+        if (!kfBiosInFill()) {
+            len = kfBiosInEnd - kfBiosInStart;
+            if (len == 0)
+                return -1;
+            kfBiosInSkip = len == KF_IN_SIZE;
+            *line = kfBiosIn + kfBiosInStart;
+            kfBiosInStart = kfBiosInEnd;
+            break;
+        }
     }
+    if (len > 0 && (*line)[len - 1] == '\r')
+        len--;
+    return len;
 }
 
-void kfBiosWriteStrLen(char* value, usize len) {
-    for (usize i = 0; i < len; i++) {
-        kfBiosWriteChar(*value);
-        value++;
-    }
+// Opens a file for reading or writing binary data. The name doesn't have to be
+// null terminated. Returns NULL if it can't be opened.
+void* kfBiosFileOpen(char* name, usize len, bool write) {
+    char path[KF_PATH_SIZE];
+    if (len >= KF_PATH_SIZE)
+        return NULL;
+    for (usize i = 0; i < len; i++)
+        path[i] = name[i];
+    path[len] = '\0';
+    return fopen(path, write ? "wb" : "rb");
+}
+
+// Reads up to `len` bytes, and returns how many were read.
+usize kfBiosFileRead(void* file, void* data, usize len) {
+    return fread(data, 1, len, (FILE*) file);
+}
+
+// Returns true if all `len` bytes were written.
+bool kfBiosFileWrite(void* file, void* data, usize len) {
+    return fwrite(data, 1, len, (FILE*) file) == len;
+}
+
+// Returns true if the file was closed without errors (e.g. a failed flush).
+bool kfBiosFileClose(void* file) {
+    return fclose((FILE*) file) == 0;
+}
+
+// Maps the whole file into memory read-only and stores its size in `len`.
+// Returns NULL if it can't. The mapping stays valid after the file is closed.
+void* kfBiosFileMap(void* file, usize* len) {
+    #ifdef KF_IS_WINDOWS
+        HANDLE handle = (HANDLE) _get_osfhandle(_fileno((FILE*) file));
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(handle, &size))
+            return NULL;
+        *len = (usize) size.QuadPart;
+        if (*len == 0)
+            return "";
+        HANDLE mapping = CreateFileMapping(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL)
+            return NULL;
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        return data;
+    #else
+        struct stat st;
+        int fd = fileno((FILE*) file);
+        if (fstat(fd, &st) != 0)
+            return NULL;
+        *len = st.st_size;
+        // Empty files can't be mapped, but there's nothing to read anyway.
+        if (*len == 0)
+            return "";
+        void* data = mmap(NULL, *len, PROT_READ, MAP_PRIVATE, fd, 0);
+        return data == MAP_FAILED ? NULL : data;
+    #endif
+}
+
+void kfBiosFileUnmap(void* data, usize len) {
+    if (len == 0)
+        return;
+    #ifdef KF_IS_WINDOWS
+        UnmapViewOfFile(data);
+    #else
+        munmap(data, len);
+    #endif
+}
+
+// Reserves `size` bytes of address space without using any memory for them
+// yet. Returns NULL if it can't.
+void* kfBiosMemReserve(usize size) {
+    #ifdef KF_IS_WINDOWS
+        return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+    #else
+        void* mem = mmap(NULL, size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return mem == MAP_FAILED ? NULL : mem;
+    #endif
+}
+
+// Makes the reserved bytes from `start` up to `end` usable. They start out
+// zeroed. `start` is always 0 or a multiple of KF_MEM_COMMIT_SIZE.
+bool kfBiosMemCommit(void* mem, usize start, usize end) {
+    #ifdef KF_IS_WINDOWS
+        return VirtualAlloc((uint8_t*) mem + start, end - start, MEM_COMMIT,
+                            PAGE_READWRITE) != NULL;
+    #else
+        return mprotect((uint8_t*) mem + start, end - start,
+                        PROT_READ | PROT_WRITE) == 0;
+    #endif
+}
+
+void kfBiosMemRelease(void* mem, usize size) {
+    #ifdef KF_IS_WINDOWS
+        (void) size;
+        VirtualFree(mem, 0, MEM_RELEASE);
+    #else
+        munmap(mem, size);
+    #endif
 }
 
 void kfBiosSetup() {
+    // kfBiosOut does the buffering, so stdio doesn't need to.
     setbuf(stdout, NULL);
+    #ifdef KF_IS_WINDOWS
+        kfBiosOutInteractive = _isatty(_fileno(stdout));
+        kfBiosInBatch = !_isatty(_fileno(stdin));
+    #else
+        kfBiosOutInteractive = isatty(STDOUT_FILENO);
+        kfBiosInBatch = !isatty(STDIN_FILENO);
+    #endif
+    #ifdef KF_BATCH_INPUT
+        kfBiosInBatch = true;
+    #endif
     #ifndef KF_IS_WINDOWS
         // No need to disable buffering in Windows since getch() already does.
         // TODO see if this actually makes a difference on *nix systems.
+        // Batch input is read in blocks, which stdio doesn't need to buffer.
         setbuf(stdin, NULL);
     #endif
 
@@ -118,6 +380,8 @@ void kfBiosSetup() {
     kfBiosCR();
 }
 
-void kfBiosTeardown() {}
+void kfBiosTeardown() {
+    kfBiosFlush();
+}
 
 #endif // KF_BIOS_H
@@ -0,0 +1,144 @@
+#ifndef KF_DICT_H
+#define KF_DICT_H
+
+/*
+ * kfDict.h (last modified 2026-10-18)
+ * This contains the dictionary lookup used by FIND. Names are matched without
+ * regard to case, and only words reachable from `latest` are visible, so the
+ * newest definition of a name wins. Defining KF_HASHED_FIND adds a hash index
+ * of the visible words so lookups don't have to walk the whole dictionary.
+ */
+
+#include "kfBios.h"
+#include "kfScan.h"
+#include "kfType.h"
+
+
+
+// How full the hash index can get before lookups go back to walking the words.
+#define KF_DICT_HASH_LIMIT (KF_FIND_HASH_SIZE / 4 * 3)
+
+
+
+bool kfDictNameEq(kfWord* word, uint8_t* name, uint8_t len) {
+    return word->name_len == len && kfScanEqFold((uint8_t*) word->name, name, len);
+}
+
+kfWord* kfDictFindLinear(kopForth* forth, uint8_t* name, uint8_t len) {
+    for (kfWord* word = forth->latest; word != NULL; word = word->link) {
+        if (kfDictNameEq(word, name, len))
+            return word;
+    }
+    return NULL;
+}
+
+#ifdef KF_HASHED_FIND
+// FNV-1a of the case folded name.
+usize kfDictHash(uint8_t* name, uint8_t len) {
+    uint32_t hash = 2166136261u;
+    for (uint8_t i = 0; i < len; i++) {
+        hash ^= kfScanFold(name[i]);
+        hash *= 16777619u;
+    }
+    return hash & (KF_FIND_HASH_SIZE - 1);
+}
+
+void kfDictInit(kopForth* forth) {
+    for (usize i = 0; i < KF_FIND_HASH_SIZE; i++)
+        forth->hash[i] = NULL;
+    forth->hash_count = 0;
+    forth->hash_latest = NULL;
+    forth->hash_clear = true;
+}
+
+// Marks the index as needing to be cleared, which waits until the first
+// lookup so starting a system doesn't have to touch all of `hash`.
+void kfDictReset(kopForth* forth) {
+    forth->hash_latest = NULL;
+    forth->hash_clear = false;
+}
+
+// How far down the word is, counting `mem` and the kernel of the system and
+// then of each parent it was cloned from.
+usize kfDictDepth(kopForth* forth, kfWord* word) {
+    usize depth = 0;
+    for (; forth != NULL; forth = forth->parent) {
+        if (kfInMem(forth, word))
+            return depth;
+        if (kfInKernel(forth, word))
+            return depth + 1;
+        depth += 2;
+    }
+    return depth;
+}
+
+// Words are always created at HERE, so newer words have higher addresses,
+// except that anything in `mem` is newer than the kernel under it.
+bool kfDictNewer(kopForth* forth, kfWord* a, kfWord* b) {
+    usize depth_a = kfDictDepth(forth, a);
+    usize depth_b = kfDictDepth(forth, b);
+    if (depth_a != depth_b)
+        return depth_a < depth_b;
+    return (usize) a > (usize) b;
+}
+
+// Adds a word to the index, unless a newer word with the same name is already
+// in it.
+void kfDictInsert(kopForth* forth, kfWord* word) {
+    if (forth->hash_count >= KF_DICT_HASH_LIMIT)
+        return;
+    uint8_t* name = (uint8_t*) word->name;
+    usize i = kfDictHash(name, word->name_len);
+    while (forth->hash[i] != NULL) {
+        kfWord* other = forth->hash[i];
+        if (kfDictNameEq(other, name, word->name_len)) {
+            if (kfDictNewer(forth, word, other))
+                forth->hash[i] = word;
+            return;
+        }
+        i = (i + 1) & (KF_FIND_HASH_SIZE - 1);
+    }
+    forth->hash[i] = word;
+    forth->hash_count++;
+}
+
+// Brings the index up to date with `latest`. New words are linked in front of
+// the old `latest`, so usually only those need to be added. If the old
+// `latest` isn't in the chain anymore (e.g. the dictionary was rolled back
+// through LP) or it was never cleared, then the index is rebuilt from scratch.
+// Rolling back DP is caught by kopForthCreateWord, which clears `hash_latest`
+// when a word is made at or below it.
+void kfDictSync(kopForth* forth) {
+    if (forth->latest == forth->hash_latest && forth->hash_clear)
+        return;
+    kfWord* stop = forth->latest;
+    while (stop != NULL && stop != forth->hash_latest)
+        stop = stop->link;
+    if (stop != forth->hash_latest || !forth->hash_clear)
+        kfDictInit(forth);
+    for (kfWord* word = forth->latest; word != stop; word = word->link)
+        kfDictInsert(forth, word);
+    forth->hash_latest = forth->latest;
+}
+#endif
+
+// Returns the newest visible word called `name`, or NULL if there isn't one.
+kfWord* kfDictFind(kopForth* forth, uint8_t* name, uint8_t len) {
+    if (len == 0)
+        return NULL;
+    #ifdef KF_HASHED_FIND
+        kfDictSync(forth);
+        if (forth->hash_count < KF_DICT_HASH_LIMIT) {
+            usize i = kfDictHash(name, len);
+            while (forth->hash[i] != NULL) {
+                if (kfDictNameEq(forth->hash[i], name, len))
+                    return forth->hash[i];
+                i = (i + 1) & (KF_FIND_HASH_SIZE - 1);
+            }
+            return NULL;
+        }
+    #endif
+    return kfDictFindLinear(forth, name, len);
+}
+
+#endif // KF_DICT_H
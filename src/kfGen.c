@@ -0,0 +1,230 @@
+/*
+ * kfGen.c (last modified 2026-10-17)
+ * This builds the kernel dictionary the same way kopForthInit does and writes
+ * it out as C, so a build with KF_PREBUILT_KERNEL defined can start with the
+ * kernel already linked into read-only data instead of building it in `mem`.
+ * It uses the image walk from kfImage.h to find the links, xts, and branch
+ * targets, which become pointers into the generated struct, and the native
+ * functions, which become references to the functions themselves.
+ * Build and run it with the same build options as the program that uses it:
+ *   gcc kfGen.c -o kfGen && ./kfGen kfKernel.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef KF_PREBUILT_KERNEL
+    #error "kfGen has to build the kernel itself, don't define KF_PREBUILT_KERNEL"
+#endif
+
+// Include the main kopForth header.
+#include "kopForth.h"
+
+
+
+// How many bytes go on each line of a byte array.
+#define GEN_BYTES_PER_LINE 12
+// Marks a cell in genCells that's just bytes.
+#define GEN_RAW (UINT32_MAX - 1)
+
+
+
+// The names of the native functions, for referring to them in the kernel.
+static const char* genNativeNames[] = {
+    FOREACH_KF_NATIVE(GENERATE_KF_NATIVE_STRING)
+};
+
+// What each byte of `mem` starts, either GEN_RAW or what kfImageWalk saw there.
+static uint32_t genCells[KF_MEM_SIZE];
+
+
+
+// Records a cell from kfImageWalk. Every pointer has to be into the kernel,
+// since the kernel doesn't know where the kopForth struct is.
+kfStatus genVisit(kopForth* forth, void* ctx, uint8_t* cell, uint32_t native) {
+    (void) ctx;
+    usize offset = cell - forth->mem;
+    if (native == KF_IMAGE_PTR) {
+        uint8_t* value = *(uint8_t**) cell;
+        if (value < forth->mem || value > forth->here) {
+            fprintf(stderr, "Cell %d points outside of the kernel\n", (int) offset);
+            return KF_IMAGE_BAD;
+        }
+    }
+    genCells[offset] = native;
+    return KF_STATUS_OK;
+}
+
+// Prints a pointer to a word in the kernel, as an offset into kfKernel.
+void genWord(FILE* out, kopForth* forth, kfWord* word) {
+    if (word == NULL)
+        fprintf(out, "NULL");
+    else
+        fprintf(out, "KF_KERNEL_WORD(%d)", (int) ((uint8_t*) word - forth->mem));
+}
+
+bool genWordOk(kopForth* forth, kfWord* word) {
+    return word == NULL || ((uint8_t*) word >= forth->mem && (uint8_t*) word < forth->here);
+}
+
+// Writes the struct that holds the kernel. A run of plain bytes becomes a byte
+// array, and every cell that kfImageWalk found becomes its own field.
+void genKernel(FILE* out, kopForth* forth) {
+    usize used = forth->here - forth->mem;
+
+    fprintf(out, "typedef struct kfKernelData kfKernelData;\n");
+    fprintf(out, "struct kfKernelData {\n");
+    for (usize i = 0; i < used;) {
+        if (genCells[i] == KF_IMAGE_PTR) {
+            fprintf(out, "    const void*  p%d;\n", (int) i);
+            i += sizeof(isize);
+        } else if (genCells[i] != GEN_RAW) {
+            fprintf(out, "    kfNativeFunc n%d;\n", (int) i);
+            i += sizeof(isize);
+        } else {
+            usize end = i;
+            while (end < used && genCells[end] == GEN_RAW)
+                end++;
+            fprintf(out, "    uint8_t      b%d[%d];\n", (int) i, (int) (end - i));
+            i = end;
+        }
+    }
+    fprintf(out, "}__attribute__((packed, aligned(sizeof(isize))));\n\n");
+
+    fprintf(out, "static const kfKernelData kfKernel = {\n");
+    for (usize i = 0; i < used;) {
+        if (genCells[i] == KF_IMAGE_PTR) {
+            uint8_t* value = *(uint8_t**) &forth->mem[i];
+            fprintf(out, "    KF_KERNEL_PTR(%d),\n", (int) (value - forth->mem));
+            i += sizeof(isize);
+        } else if (genCells[i] != GEN_RAW) {
+            fprintf(out, "    %s,\n", genNativeNames[genCells[i]]);
+            i += sizeof(isize);
+        } else {
+            fprintf(out, "    {");
+            for (usize n = 0; i < used && genCells[i] == GEN_RAW; i++, n++) {
+                if (n % GEN_BYTES_PER_LINE == 0)
+                    fprintf(out, "\n        ");
+                fprintf(out, "0x%02X,", forth->mem[i]);
+            }
+            fprintf(out, "\n    },\n");
+        }
+    }
+    fprintf(out, "};\n\n");
+}
+
+// Writes everything that kfKernelInit copies into the kopForth struct.
+void genSystem(FILE* out, kopForth* forth) {
+    kfWord** dw = (kfWord**) &forth->debug_words;
+    fprintf(out, "static const kfDebugWords kfKernelDebugWords = {\n");
+    for (usize i = 0; i < sizeof(kfDebugWords) / sizeof(kfWord*); i++) {
+        fprintf(out, "    ");
+        genWord(out, forth, dw[i]);
+        fprintf(out, ",\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const kfFuseRule kfKernelFuseRules[KF_FUSE_RULES] = {\n");
+    for (usize i = 0; i < KF_FUSE_RULES; i++) {
+        kfFuseRule* rule = &forth->fuse_rules[i];
+        fprintf(out, "    {");
+        genWord(out, forth, rule->first);
+        fprintf(out, ", %d, ", (int) rule->args);
+        genWord(out, forth, rule->second);
+        fprintf(out, ", ");
+        genWord(out, forth, rule->fused);
+        fprintf(out, "},\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const kfFoldRule kfKernelFoldRules[KF_FOLD_RULES] = {\n");
+    for (usize i = 0; i < KF_FOLD_RULES; i++) {
+        kfFoldRule* rule = &forth->fold_rules[i];
+        fprintf(out, "    {");
+        genWord(out, forth, rule->word);
+        fprintf(out, ", %d, %d},\n", rule->in, rule->out);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "#define KF_KERNEL_LATEST ");
+    genWord(out, forth, forth->latest);
+    fprintf(out, "\n\n");
+}
+
+// Checks that every word the system keeps a pointer to is in the kernel.
+bool genSystemOk(kopForth* forth) {
+    kfWord** dw = (kfWord**) &forth->debug_words;
+    for (usize i = 0; i < sizeof(kfDebugWords) / sizeof(kfWord*); i++) {
+        if (!genWordOk(forth, dw[i]))
+            return false;
+    }
+    for (usize i = 0; i < KF_FUSE_RULES; i++) {
+        kfFuseRule* rule = &forth->fuse_rules[i];
+        if (!genWordOk(forth, rule->first) || !genWordOk(forth, rule->second) ||
+            !genWordOk(forth, rule->fused))
+            return false;
+    }
+    for (usize i = 0; i < KF_FOLD_RULES; i++) {
+        if (!genWordOk(forth, forth->fold_rules[i].word))
+            return false;
+    }
+    return genWordOk(forth, forth->latest);
+}
+
+
+
+int main(int argc, char** argv) {
+    char* name = argc > 1 ? argv[1] : "kfKernel.h";
+
+    kfBiosSetup();
+    static kopForth forth;
+    kfStatus s = kopForthInit(&forth);
+    if (kfStatusIsOk(s)) {
+        for (usize i = 0; i < KF_MEM_SIZE; i++)
+            genCells[i] = GEN_RAW;
+        s = kfImageWalk(&forth, genVisit, NULL);
+    }
+    kfBiosTeardown();
+    if (!kfStatusIsOk(s)) {
+        fprintf(stderr, "Error: %d (%s)\n", s, kfStatusStr[s]);
+        return s;
+    }
+    if (!genSystemOk(&forth)) {
+        fprintf(stderr, "A system word isn't in the kernel\n");
+        return 1;
+    }
+
+    FILE* out = fopen(name, "w");
+    if (out == NULL) {
+        fprintf(stderr, "Can't open %s\n", name);
+        return 1;
+    }
+    fprintf(out, "#ifndef KF_KERNEL_H\n#define KF_KERNEL_H\n\n");
+    fprintf(out, "/*\n");
+    fprintf(out, " * kfKernel.h\n");
+    fprintf(out, " * This is the prebuilt kernel dictionary used when KF_PREBUILT_KERNEL is\n");
+    fprintf(out, " * defined. It's generated by kfGen.c, so don't edit it.\n");
+    fprintf(out, " */\n\n");
+    fprintf(out, "#include \"kfImage.h\"\n");
+    fprintf(out, "#include \"kfType.h\"\n\n\n\n");
+    fprintf(out, "// The build this kernel was generated for.\n");
+    fprintf(out, "#define KF_KERNEL_UINTPTR_MAX      0x%jXu\n", (uintmax_t) UINTPTR_MAX);
+    fprintf(out, "#define KF_KERNEL_MAX_NAME_SIZE    %d\n", KF_MAX_NAME_SIZE);
+    fprintf(out, "#define KF_KERNEL_FUSE_RULES       %d\n", KF_FUSE_RULES);
+    fprintf(out, "#define KF_KERNEL_FOLD_RULES       %d\n", KF_FOLD_RULES);
+    #ifdef KF_NATIVE_STACK_MEM
+        fprintf(out, "#define KF_KERNEL_NATIVE_STACK_MEM 1\n\n");
+    #else
+        fprintf(out, "#define KF_KERNEL_NATIVE_STACK_MEM 0\n\n");
+    #endif
+    fprintf(out, "#define KF_KERNEL_PTR(offset)  ((const uint8_t*) &kfKernel + (offset))\n");
+    fprintf(out, "#define KF_KERNEL_WORD(offset) ((kfWord*) KF_KERNEL_PTR(offset))\n\n\n\n");
+    genKernel(out, &forth);
+    genSystem(out, &forth);
+    fprintf(out, "#endif // KF_KERNEL_H\n");
+    if (fclose(out) != 0) {
+        fprintf(stderr, "Can't write %s\n", name);
+        return 1;
+    }
+    return 0;
+}
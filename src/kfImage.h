@@ -0,0 +1,352 @@
+#ifndef KF_IMAGE_H
+#define KF_IMAGE_H
+
+/*
+ * kfImage.h (last modified 2026-10-17)
+ * This contains saving the dictionary to an image file and loading it back, so
+ * a system with its vocabulary already compiled can start without rebuilding
+ * it. The used part of `mem` is written as-is, followed by a relocation entry
+ * for every cell that points into `mem` or the kopForth struct (links, xts,
+ * branch targets, and literal addresses) and for every native function
+ * pointer, which is saved as its index in kfNatives. Loading reads `mem` back
+ * in one go and rebases those cells onto the new system.
+ * Any cell holding a number that happens to equal an address in `mem` or the
+ * struct will be rebased too. That's only likely on targets with small address spaces.
+ * When the system was started from a prebuilt kernel, pointers into the kernel
+ * are rebased onto it instead, and the walk over the words stops at the kernel.
+ * kfGen.c uses the same walk to find the cells it has to emit as pointers.
+ */
+
+#include "kfBios.h"
+#include "kfStatus.h"
+#include "kfType.h"
+#include "kfWordsIntComp.h"
+#include "kfWordsNative.h"
+#include "kfWordsStackMem.h"
+#include "kfWordsString.h"
+
+
+
+// Bumped whenever the layout of the image changes.
+#define KF_IMAGE_VERSION 3
+// The `native` of a relocation entry for a cell that's a pointer.
+#define KF_IMAGE_PTR UINT32_MAX
+// The `offset` of the entry that ends the relocation entries.
+#define KF_IMAGE_END UINT32_MAX
+// How many relocation entries are read at a time while loading.
+#define KF_IMAGE_CHUNK 256
+
+
+
+// Pointers to words created in this file, for usage in defining other words.
+typedef struct kfWordsImage kfWordsImage;
+struct kfWordsImage {
+    kfWord* sim;
+};
+
+// Necessary typedef declarations for types.
+typedef struct kfImageHeader kfImageHeader;
+typedef struct kfImageFixup  kfImageFixup;
+
+// Everything about the system that isn't in `mem`. The pointers are saved as
+// they were, and get rebased from `old_forth` when loaded.
+struct kfImageHeader {
+    char         magic[4];
+    uint16_t     version;
+    uint8_t      cell_size;
+    uint8_t      name_size;
+    uint32_t     natives;
+    uint32_t     forth_size;
+    uint32_t     used;
+    usize        old_forth;
+    usize        old_mem;
+    usize        old_kernel;
+    uint32_t     kernel_size;
+    uint8_t*     here;
+    kfWord*      latest;
+    kfWord*      pending;
+    isize        base;
+    kfDebugWords debug_words;
+    kfFuseRule   fuse_rules[KF_FUSE_RULES];
+    kfFoldRule   fold_rules[KF_FOLD_RULES];
+};
+
+// A cell in `mem` that has to be fixed up after loading. It's either a pointer
+// into the kopForth struct, or the index of a native function in kfNatives.
+struct kfImageFixup {
+    uint32_t offset;
+    uint32_t native;
+};
+
+
+
+// Every native function, so they can be saved by index. Their indexes have to
+// stay the same for old images to load, so new natives go at the end.
+kfStatus W_Sim(kopForth* forth);
+
+#define FOREACH_KF_NATIVE(NATIVE) \
+        NATIVE(W_Ext) NATIVE(W_Lit) NATIVE(W_Sub) NATIVE(W_Mul) NATIVE(W_Dot) \
+        NATIVE(W_Att) NATIVE(W_Exc) NATIVE(W_Cat) NATIVE(W_Cex) NATIVE(W_Rpu) \
+        NATIVE(W_Rpo) NATIVE(W_Drp) NATIVE(W_Dup) NATIVE(W_Swp) NATIVE(W_Bra) \
+        NATIVE(W_Zbr) NATIVE(W_Emt) NATIVE(W_Key) NATIVE(W_Acc) NATIVE(W_Wrd) \
+        NATIVE(W_Typ) NATIVE(W_Cre) NATIVE(W_Imm) NATIVE(W_Cmp) NATIVE(W_Fnd) \
+        NATIVE(W_Mss) NATIVE(W_Dpl) NATIVE(W_Ums) NATIVE(W_Mst) NATIVE(W_Umm) \
+        NATIVE(W_Smr) NATIVE(W_Fmm) NATIVE(W_Div) NATIVE(W_Mod) NATIVE(W_Dmo) \
+        NATIVE(W_Sts) NATIVE(W_Ssm) NATIVE(W_Dmi) NATIVE(W_Dng) NATIVE(W_Dls) \
+        NATIVE(W_Deq) NATIVE(W_Dab) NATIVE(W_Dtt) NATIVE(W_Equ) NATIVE(W_Lss) \
+        NATIVE(W_Nan) NATIVE(W_Psq) NATIVE(W_Squ) NATIVE(W_Dqu) NATIVE(W_Bye) \
+        NATIVE(W_Dos) NATIVE(W_Dpt) NATIVE(W_Crs) NATIVE(W_Cds) NATIVE(W_Ovr) \
+        NATIVE(W_Rot) NATIVE(W_Tdr) NATIVE(W_Tdu) NATIVE(W_Add) NATIVE(W_Inv) \
+        NATIVE(W_Orr) NATIVE(W_And) NATIVE(W_Xor) NATIVE(W_Lsh) NATIVE(W_Rsh) \
+        NATIVE(W_Zeq) NATIVE(W_Neq) NATIVE(W_Leq) NATIVE(W_Gtr) NATIVE(W_Geq) \
+        NATIVE(W_Cls) NATIVE(W_Pex) NATIVE(W_Dig) NATIVE(W_Num) NATIVE(W_Snu) \
+        NATIVE(W_Lad) NATIVE(W_Dzb) NATIVE(W_Ovo) NATIVE(W_Rro) NATIVE(W_Nip) \
+        NATIVE(W_Cpl) NATIVE(W_Frs) NATIVE(W_Tex) NATIVE(W_Inl) NATIVE(W_Fsd) \
+        NATIVE(W_Sim) NATIVE(W_Usr) NATIVE(W_Exe) NATIVE(W_Alt) NATIVE(W_Rfl) \
+        NATIVE(W_Src) NATIVE(W_Ifl) NATIVE(W_Ind) NATIVE(W_Sen) NATIVE(W_Idq) \
+        NATIVE(W_Srs) NATIVE(W_Sid) NATIVE(W_Evs) NATIVE(W_Evd) NATIVE(W_Prs) \
+        NATIVE(W_Pnm) NATIVE(W_Fnm) NATIVE(W_Pfn) NATIVE(W_Cmt) NATIVE(W_Bsl) \
+
+#define GENERATE_KF_NATIVE(FUNC)        FUNC,
+#define GENERATE_KF_NATIVE_STRING(FUNC) #FUNC,
+
+static const kfNativeFunc kfNatives[] = {
+    FOREACH_KF_NATIVE(GENERATE_KF_NATIVE)
+};
+
+#define KF_NATIVE_COUNT (sizeof(kfNatives) / sizeof(kfNatives[0]))
+
+
+
+// Gets called with every cell that has to be fixed up when the dictionary
+// moves. `native` is the cell's index in kfNatives, or KF_IMAGE_PTR if it's a
+// pointer.
+typedef kfStatus (*kfImageVisit)(kopForth* forth, void* ctx, uint8_t* cell, uint32_t native);
+
+// Checks if the cell holds a pointer into `mem`, the kopForth struct, or the
+// kernel.
+bool kfImageIsPtr(kopForth* forth, uint8_t* cell) {
+    usize value = *(usize*) cell;
+    return (value >= (usize) forth->mem && value <= (usize) forth->here) ||
+           (value >= (usize) forth && value <= (usize) (forth + 1)) ||
+           kfInKernel(forth, (void*) value);
+}
+
+uint32_t kfImageNative(kfNativeFunc func) {
+    uint32_t i = 0;
+    while (i < KF_NATIVE_COUNT && kfNatives[i] != func)
+        i++;
+    return i;
+}
+
+// Visits the cells of every word in `mem`, newest first. Each word runs up to
+// the start of the next one (or HERE), and everything after its header is
+// checked a cell at a time, skipping over the strings of `(S")`.
+kfStatus kfImageWalk(kopForth* forth, kfImageVisit visit, void* ctx) {
+    uint8_t* end = forth->here;
+    for (kfWord* word = forth->pending; word != NULL; word = word->link) {
+        if (kfInKernel(forth, word))
+            break;
+        if ((uint8_t*) word < forth->mem || (uint8_t*) word >= end)
+            return KF_IMAGE_BAD;
+        if (kfImageIsPtr(forth, (uint8_t*) &word->link))
+            KF_RETURN_IF_ERROR(visit(forth, ctx, (uint8_t*) &word->link, KF_IMAGE_PTR));
+        uint8_t* cell = (uint8_t*) word->word_def.forth;
+        if (word->flags.bit_flags.is_native) {
+            uint32_t i = kfImageNative(word->word_def.native);
+            if (i == KF_NATIVE_COUNT)
+                return KF_IMAGE_BAD;
+            KF_RETURN_IF_ERROR(visit(forth, ctx, cell, i));
+            cell += 2 * sizeof(isize);
+        }
+        while (cell + sizeof(isize) <= end) {
+            if (kfImageIsPtr(forth, cell))
+                KF_RETURN_IF_ERROR(visit(forth, ctx, cell, KF_IMAGE_PTR));
+            kfWord* xt = *(kfWord**) cell;
+            cell += sizeof(isize);
+            if (xt == forth->debug_words.psq && cell < end)
+                cell += 1 + *cell;
+        }
+        end = (uint8_t*) word;
+    }
+    return KF_STATUS_OK;
+}
+
+// Writes the relocation entry for a cell to the image file in `ctx`.
+kfStatus kfImageWriteFixup(kopForth* forth, void* ctx, uint8_t* cell, uint32_t native) {
+    kfImageFixup fix = {(uint32_t) (cell - forth->mem), native};
+    if (!kfBiosFileWrite(ctx, &fix, sizeof(fix)))
+        return KF_IMAGE_IO;
+    return KF_STATUS_OK;
+}
+
+// A clone's kernel can have its parent's kernel under it, which an image has
+// no way of pointing into, so clones can't be saved.
+kfStatus kfImageSave(kopForth* forth, char* name, usize len) {
+    if (forth->parent != NULL)
+        return KF_SYSTEM_NOT_IMP;
+    kfImageHeader header = {
+        .magic = {'k', 'f', 'I', 'm'},
+        .version = KF_IMAGE_VERSION,
+        .cell_size = sizeof(isize),
+        .name_size = KF_MAX_NAME_SIZE,
+        .natives = KF_NATIVE_COUNT,
+        .forth_size = sizeof(kopForth),
+        .used = (uint32_t) (forth->here - forth->mem),
+        .old_forth = (usize) forth,
+        .old_mem = (usize) forth->mem,
+        .old_kernel = (usize) forth->kernel,
+        .kernel_size = (uint32_t) forth->kernel_size,
+        .here = forth->here,
+        .latest = forth->latest,
+        .pending = forth->pending,
+        .base = forth->base,
+        .debug_words = forth->debug_words,
+    };
+    for (usize i = 0; i < KF_FUSE_RULES; i++)
+        header.fuse_rules[i] = forth->fuse_rules[i];
+    for (usize i = 0; i < KF_FOLD_RULES; i++)
+        header.fold_rules[i] = forth->fold_rules[i];
+
+    void* file = kfBiosFileOpen(name, len, true);
+    if (file == NULL)
+        return KF_IMAGE_IO;
+    kfStatus s = KF_STATUS_OK;
+    if (!kfBiosFileWrite(file, &header, sizeof(header)) ||
+        !kfBiosFileWrite(file, forth->mem, header.used))
+        s = KF_IMAGE_IO;
+    if (kfStatusIsOk(s))
+        s = kfImageWalk(forth, kfImageWriteFixup, file);
+    kfImageFixup end = {KF_IMAGE_END, KF_IMAGE_PTR};
+    if (kfStatusIsOk(s) && !kfBiosFileWrite(file, &end, sizeof(end)))
+        s = KF_IMAGE_IO;
+    if (!kfBiosFileClose(file) && kfStatusIsOk(s))
+        s = KF_IMAGE_IO;
+    return s;
+}
+
+bool kfImageWasInMem(kfImageHeader* header, usize value) {
+    return value >= header->old_mem && value <= header->old_mem + header->used;
+}
+
+bool kfImageWasInKernel(kfImageHeader* header, usize value) {
+    return header->kernel_size != 0 && value >= header->old_kernel &&
+           value <= header->old_kernel + header->kernel_size;
+}
+
+bool kfImageWasInForth(kfImageHeader* header, usize value) {
+    return value >= header->old_forth && value <= header->old_forth + header->forth_size;
+}
+
+// Moves a pointer from the saved `mem`, struct, or kernel onto `forth`.
+void* kfImageRebase(kopForth* forth, kfImageHeader* header, void* ptr) {
+    if (ptr == NULL)
+        return NULL;
+    if (kfImageWasInMem(header, (usize) ptr))
+        return forth->mem + ((usize) ptr - header->old_mem);
+    if (kfImageWasInKernel(header, (usize) ptr))
+        return forth->kernel + ((usize) ptr - header->old_kernel);
+    return (uint8_t*) forth + ((usize) ptr - header->old_forth);
+}
+
+// Applies the relocation entries that follow `mem` in the image.
+kfStatus kfImageRelocate(kopForth* forth, void* file, kfImageHeader* header) {
+    kfImageFixup fixes[KF_IMAGE_CHUNK];
+    while (true) {
+        usize count = kfBiosFileRead(file, fixes, sizeof(fixes)) / sizeof(fixes[0]);
+        if (count == 0)
+            return KF_IMAGE_IO;
+        for (usize i = 0; i < count; i++) {
+            kfImageFixup* fix = &fixes[i];
+            if (fix->offset == KF_IMAGE_END)
+                return KF_STATUS_OK;
+            if (fix->offset + sizeof(isize) > header->used)
+                return KF_IMAGE_BAD;
+            uint8_t* cell = forth->mem + fix->offset;
+            if (fix->native == KF_IMAGE_PTR) {
+                usize value = *(usize*) cell;
+                if (!kfImageWasInMem(header, value) &&
+                    !kfImageWasInForth(header, value) &&
+                    !kfImageWasInKernel(header, value))
+                    return KF_IMAGE_BAD;
+                *(void**) cell = kfImageRebase(forth, header, (void*) value);
+            } else {
+                if (fix->native >= header->natives)
+                    return KF_IMAGE_BAD;
+                *(kfNativeFunc*) cell = kfNatives[fix->native];
+            }
+        }
+    }
+}
+
+// Loads an image into a system that's been set up like kopForthInit does,
+// except for the dictionary.
+kfStatus kfImageLoad(kopForth* forth, char* name, usize len) {
+    void* file = kfBiosFileOpen(name, len, false);
+    if (file == NULL)
+        return KF_IMAGE_IO;
+    kfImageHeader header;
+    kfStatus s = KF_STATUS_OK;
+    if (kfBiosFileRead(file, &header, sizeof(header)) != sizeof(header))
+        s = KF_IMAGE_IO;
+    else if (header.magic[0] != 'k' || header.magic[1] != 'f' ||
+             header.magic[2] != 'I' || header.magic[3] != 'm' ||
+             header.version != KF_IMAGE_VERSION ||
+             header.cell_size != sizeof(isize) ||
+             header.name_size != KF_MAX_NAME_SIZE ||
+             header.natives > KF_NATIVE_COUNT ||
+             header.forth_size != sizeof(kopForth) ||
+             header.kernel_size != forth->kernel_size ||
+             header.used > forth->mem_size)
+        s = KF_IMAGE_BAD;
+    else if (!kfCanFitInMem(forth, header.used))
+        s = KF_MEM_FULL;
+    else if (kfBiosFileRead(file, forth->mem, header.used) != header.used)
+        s = KF_IMAGE_IO;
+    if (kfStatusIsOk(s))
+        s = kfImageRelocate(forth, file, &header);
+    kfBiosFileClose(file);
+    if (!kfStatusIsOk(s))
+        return s;
+
+    forth->here = kfImageRebase(forth, &header, header.here);
+    forth->latest = kfImageRebase(forth, &header, header.latest);
+    forth->pending = kfImageRebase(forth, &header, header.pending);
+    forth->base = header.base;
+    kfWord** dw = (kfWord**) &header.debug_words;
+    for (usize i = 0; i < sizeof(kfDebugWords) / sizeof(kfWord*); i++)
+        ((kfWord**) &forth->debug_words)[i] = kfImageRebase(forth, &header, dw[i]);
+    for (usize i = 0; i < KF_FUSE_RULES; i++) {
+        kfFuseRule* rule = &header.fuse_rules[i];
+        forth->fuse_rules[i].first = kfImageRebase(forth, &header, rule->first);
+        forth->fuse_rules[i].args = rule->args;
+        forth->fuse_rules[i].second = kfImageRebase(forth, &header, rule->second);
+        forth->fuse_rules[i].fused = kfImageRebase(forth, &header, rule->fused);
+    }
+    for (usize i = 0; i < KF_FOLD_RULES; i++) {
+        forth->fold_rules[i] = header.fold_rules[i];
+        forth->fold_rules[i].word =
+            kfImageRebase(forth, &header, header.fold_rules[i].word);
+    }
+    return KF_STATUS_OK;
+}
+
+
+
+// Native word implementations.
+
+kfStatus W_Sim(kopForth* forth) {  // "name" -- ior
+    usize len;
+    uint8_t* name = kfParseName(forth, &len);
+    KF_DATA_PUSH(kfImageSave(forth, (char*) name, len));
+    return KF_STATUS_OK;
+}
+
+
+
+// Fill image words into memory.
+void kfPopulateWordsImage(kopForth* forth, kfWordsImage* wg) {
+    wg->sim = kopForthAddNativeWord(forth, "SAVE-IMAGE", W_Sim, false);  // ( "name" -- ior )
+}
+
+#endif // KF_IMAGE_H
@@ -2,10 +2,14 @@
 #define KF_MATH_H
 
 /*
- * kfMath.h (last modified 2025-05-27)
+ * kfMath.h (last modified 2026-10-17)
  * This is an arbitrary precision math library used for handling the double cell
  * math operations of Forth in a platform-agnostic way that's easy to manually
  * port from an algorithmic standpoint.
+ * Numbers are worked on as little endian arrays of limbs. By default a limb is
+ * a whole cell when the compiler has __int128 to multiply them into, otherwise
+ * it's 32 bits. Defining KF_MATH_BYTES makes them single bytes, so nothing
+ * wider than 16 bits is ever needed.
  */
 
 #include "kfBios.h"
@@ -13,13 +17,27 @@
 
 
 // Necessary typedef declarations for types.
-typedef struct TwoCell  TwoCell;
-typedef struct ByteCell ByteCell;
+typedef struct TwoCell TwoCell;
 
+#if defined(KF_MATH_BYTES)
+    typedef uint8_t  kfLimb;
+    typedef uint16_t kfLimbWide;
+#elif defined(__SIZEOF_INT128__) && UINTPTR_MAX == UINT64_MAX
+    typedef uint64_t          kfLimb;
+    typedef unsigned __int128 kfLimbWide;
+#elif UINTPTR_MAX >= UINT32_MAX
+    typedef uint32_t kfLimb;
+    typedef uint64_t kfLimbWide;
+#else
+    typedef uint16_t kfLimb;
+    typedef uint32_t kfLimbWide;
+#endif
 
 
-#define ISIZE_SIZE     sizeof(isize)
-#define BYTE_CELL_SIZE ISIZE_SIZE * 2
+
+#define ISIZE_SIZE sizeof(isize)
+#define LIMB_BITS  (sizeof(kfLimb) * 8)
+#define CELL_LIMBS (ISIZE_SIZE / sizeof(kfLimb))
 
 
 
@@ -29,148 +47,203 @@ struct TwoCell {
     isize high;
 };
 
-// Used to actually do the math.
-struct ByteCell {
-    // Stored in little endian
-    uint8_t bytes[BYTE_CELL_SIZE];
-};
-
 
 
 // Conversion functions.
 
-ByteCell TwoCellToByteCell(TwoCell input) {
-    ByteCell output;
-    for (int i = 0; i < ISIZE_SIZE; i++) {
-        output.bytes[i] = input.low & 0xFF;
-        input.low >>= 8;
+// Splits `count` cells into limbs, lowest cell first.
+void CellsToLimbs(usize* cells, usize count, kfLimb* limbs) {
+    for (usize i = 0; i < count; i++) {
+        for (usize j = 0; j < CELL_LIMBS; j++)
+            limbs[i * CELL_LIMBS + j] = (kfLimb) (cells[i] >> (j * LIMB_BITS));
     }
-    for (int i = ISIZE_SIZE; i < BYTE_CELL_SIZE; i++) {
-        output.bytes[i] = input.high & 0xFF;
-        input.high >>= 8;
+}
+
+void LimbsToCells(kfLimb* limbs, usize count, usize* cells) {
+    for (usize i = 0; i < count; i++) {
+        cells[i] = 0;
+        for (usize j = 0; j < CELL_LIMBS; j++)
+            cells[i] |= (usize) limbs[i * CELL_LIMBS + j] << (j * LIMB_BITS);
     }
-    return output;
 }
 
-TwoCell ByteCellToTwoCell(ByteCell input) {
+void TwoCellToLimbs(TwoCell input, kfLimb* limbs) {
+    usize cells[2] = {(usize) input.low, (usize) input.high};
+    CellsToLimbs(cells, 2, limbs);
+}
+
+TwoCell LimbsToTwoCell(kfLimb* limbs) {
+    usize cells[2];
+    LimbsToCells(limbs, 2, cells);
     TwoCell output;
-    for (int i = ISIZE_SIZE - 1; i >= 0; i--) {
-        output.low <<= 8;
-        output.low |= input.bytes[i];
-    }
-    for (int i = BYTE_CELL_SIZE - 1; i >= ISIZE_SIZE; i--) {
-        output.high <<= 8;
-        output.high |= input.bytes[i];
-    }
+    output.low = (isize) cells[0];
+    output.high = (isize) cells[1];
     return output;
 }
 
 
 
-// Math functions.
+// Limb math functions. These are all unsigned.
 
-ByteCell ByteCellsAdd(ByteCell a, ByteCell b) {
-    uint8_t carry = 0;
-    for (int i = 0; i < BYTE_CELL_SIZE; i++) {
-        uint16_t acc = a.bytes[i];
-        acc += b.bytes[i];
-        acc += carry;
-        a.bytes[i] = acc & 0xFF;
-        carry = acc >> 8;
+// a += b, with both `count` limbs long. Returns the carry out of the top.
+kfLimb LimbsAdd(kfLimb* a, kfLimb* b, usize count) {
+    kfLimbWide carry = 0;
+    for (usize i = 0; i < count; i++) {
+        carry += (kfLimbWide) a[i] + b[i];
+        a[i] = (kfLimb) carry;
+        carry >>= LIMB_BITS;
     }
-    return a;
+    return (kfLimb) carry;
 }
 
-ByteCell ByteCellShift8Left(ByteCell input) {
-    for (int i = BYTE_CELL_SIZE - 1; i > 0; i--) {
-        input.bytes[i] = input.bytes[i - 1];
+// output = a * b, so `output` needs room for a_count + b_count limbs.
+void LimbsMultiply(kfLimb* a, usize a_count, kfLimb* b, usize b_count,
+                   kfLimb* output) {
+    for (usize i = 0; i < a_count + b_count; i++)
+        output[i] = 0;
+    for (usize i = 0; i < b_count; i++) {
+        kfLimbWide carry = 0;
+        for (usize j = 0; j < a_count; j++) {
+            carry += (kfLimbWide) a[j] * b[i] + output[i + j];
+            output[i + j] = (kfLimb) carry;
+            carry >>= LIMB_BITS;
+        }
+        output[i + a_count] = (kfLimb) carry;
     }
-    input.bytes[0] = 0;
-    return input;
 }
 
-ByteCell ByteCellShift8Right(ByteCell input) {
-    for (int i = 0; i < BYTE_CELL_SIZE - 1; i++) {
-        input.bytes[i] = input.bytes[i + 1];
+// a /= div, with `a` being `count` limbs long. Returns the remainder.
+// A divisor that fits in a limb is done a limb at a time with the wide type,
+// anything bigger is done a bit at a time.
+usize LimbsDivide(kfLimb* a, usize count, usize div) {
+    if (div <= (kfLimb) -1) {
+        kfLimbWide rem = 0;
+        for (usize i = count; i-- > 0;) {
+            kfLimbWide acc = (rem << LIMB_BITS) | a[i];
+            a[i] = (kfLimb) (acc / div);
+            rem = acc % div;
+        }
+        return (usize) rem;
     }
-    input.bytes[BYTE_CELL_SIZE - 1] = 0;
-    return input;
-}
-
-ByteCell ByteCellMultiply(ByteCell a, uint8_t b) {
-    uint8_t carry = 0;
-    for (int i = 0; i < BYTE_CELL_SIZE; i++) {
-        uint16_t acc = a.bytes[i];
-        acc *= b;
-        acc += carry;
-        a.bytes[i] = acc & 0xFF;
-        carry = acc >> 8;
+    usize rem = 0;
+    for (usize i = count; i-- > 0;) {
+        kfLimb quot = 0;
+        for (usize bit = LIMB_BITS; bit-- > 0;) {
+            // If the top bit falls off, the remainder is bigger than any divisor.
+            bool carry = rem >> (ISIZE_SIZE * 8 - 1);
+            rem = (rem << 1) | ((a[i] >> bit) & 1);
+            quot <<= 1;
+            if (carry || rem >= div) {
+                rem -= div;
+                quot |= 1;
+            }
+        }
+        a[i] = quot;
     }
+    return rem;
+}
+
+
+
+// Double cell functions, wrapping at the top of the double cell.
+
+TwoCell TwoCellAdd(TwoCell a, TwoCell b) {
+    kfLimb la[2 * CELL_LIMBS], lb[2 * CELL_LIMBS];
+    TwoCellToLimbs(a, la);
+    TwoCellToLimbs(b, lb);
+    LimbsAdd(la, lb, 2 * CELL_LIMBS);
+    return LimbsToTwoCell(la);
+}
+
+TwoCell TwoCellNegate(TwoCell a) {
+    a.low = (isize) (0 - (usize) a.low);
+    a.high = (isize) (~(usize) a.high + (a.low == 0));
     return a;
 }
 
-ByteCell ByteCellsMultiply(ByteCell a, ByteCell b) {
-    TwoCell z;
-    z.high = 0;
-    z.low = 0;
-    ByteCell acc = TwoCellToByteCell(z);
-    for (int i = 0; i < BYTE_CELL_SIZE; i++) {
-        ByteCell tmp = ByteCellMultiply(a, b.bytes[i]);
-        acc = ByteCellsAdd(acc, tmp);
-        a = ByteCellShift8Left(a);
-    }
-    return acc;
+// The full double cell product of two unsigned cells.
+TwoCell UsizeMultiply(usize a, usize b) {
+    kfLimb la[CELL_LIMBS], lb[CELL_LIMBS], product[2 * CELL_LIMBS];
+    CellsToLimbs(&a, 1, la);
+    CellsToLimbs(&b, 1, lb);
+    LimbsMultiply(la, CELL_LIMBS, lb, CELL_LIMBS, product);
+    return LimbsToTwoCell(product);
+}
+
+// Unsigned a * b + c.
+TwoCell TwoCellMulAdd(TwoCell a, usize b, usize c) {
+    kfLimb la[2 * CELL_LIMBS], lb[CELL_LIMBS], product[3 * CELL_LIMBS];
+    kfLimb lc[2 * CELL_LIMBS];
+    TwoCellToLimbs(a, la);
+    CellsToLimbs(&b, 1, lb);
+    LimbsMultiply(la, 2 * CELL_LIMBS, lb, CELL_LIMBS, product);
+    TwoCell addend = {(isize) c, 0};
+    TwoCellToLimbs(addend, lc);
+    LimbsAdd(product, lc, 2 * CELL_LIMBS);
+    return LimbsToTwoCell(product);
 }
 
+// Unsigned a / b, storing the remainder in `rem`. `b` can't be 0.
+TwoCell TwoCellDivide(TwoCell a, usize b, usize* rem) {
+    kfLimb la[2 * CELL_LIMBS];
+    TwoCellToLimbs(a, la);
+    *rem = LimbsDivide(la, 2 * CELL_LIMBS, b);
+    return LimbsToTwoCell(la);
+}
+
+// Unsigned a * b / c, with a triple cell intermediate so the product doesn't
+// have to fit in a double cell. `c` can't be 0.
+TwoCell TwoCellMulDiv(TwoCell a, usize b, usize c) {
+    kfLimb la[2 * CELL_LIMBS], lb[CELL_LIMBS], product[3 * CELL_LIMBS];
+    TwoCellToLimbs(a, la);
+    CellsToLimbs(&b, 1, lb);
+    LimbsMultiply(la, 2 * CELL_LIMBS, lb, CELL_LIMBS, product);
+    LimbsDivide(product, 3 * CELL_LIMBS, c);
+    return LimbsToTwoCell(product);
+}
 
 
-/*
 
-ByteCell ByteCellDivide(ByteCell a, uint8_t b) {
-    // TODO actually write this
+// Signed functions.
+
+bool TwoCellLess(TwoCell a, TwoCell b) {
+    if (a.high != b.high)
+        return a.high < b.high;
+    return (usize) a.low < (usize) b.low;
+}
+
+TwoCell TwoCellAbs(TwoCell a) {
+    return a.high < 0 ? TwoCellNegate(a) : a;
+}
+
+// The full double cell product of two signed cells.
+TwoCell IsizeMultiply(isize a, isize b) {
+    usize ua = a < 0 ? 0 - (usize) a : (usize) a;
+    usize ub = b < 0 ? 0 - (usize) b : (usize) b;
+    TwoCell output = UsizeMultiply(ua, ub);
+    return (a < 0) != (b < 0) ? TwoCellNegate(output) : output;
 }
-void TwoCellPrint(TwoCell input) {
-    printf("%d %d\n", input.low, input.high);
+
+// Divides a by b rounding toward zero, so the remainder has the sign of `a`.
+// The quotient is cut down to a cell if it doesn't fit. `b` can't be 0.
+isize TwoCellSymDivide(TwoCell a, isize b, isize* rem) {
+    usize ub = b < 0 ? 0 - (usize) b : (usize) b;
+    usize urem;
+    TwoCell quot = TwoCellDivide(TwoCellAbs(a), ub, &urem);
+    *rem = (isize) (a.high < 0 ? 0 - urem : urem);
+    return (a.high < 0) != (b < 0) ? (isize) (0 - (usize) quot.low) : quot.low;
 }
-void ByteCellPrint(ByteCell input) {
-    for (int i = 0; i < BYTE_CELL_SIZE; i++) {
-        if (i == ISIZE_SIZE)
-            printf("  ");
-        printf("%d ", input.bytes[i]);
+
+// Divides a by b rounding toward negative infinity, so the remainder has the
+// sign of `b`. The quotient is cut down to a cell if it doesn't fit. `b` can't
+// be 0.
+isize TwoCellFloorDivide(TwoCell a, isize b, isize* rem) {
+    isize quot = TwoCellSymDivide(a, b, rem);
+    if (*rem != 0 && (*rem < 0) != (b < 0)) {
+        quot = (isize) ((usize) quot - 1);
+        *rem = (isize) ((usize) *rem + (usize) b);
     }
-    printf("\n");
-}
-void TwoCellTest() {
-    TwoCell input;
-    input.high = 0;
-    input.low = -2;
-    printf("input = ");
-    TwoCellPrint(input);
-    printf("\noutput = input\n");
-    ByteCell output = TwoCellToByteCell(input);
-    ByteCellPrint(output); TwoCellPrint(ByteCellToTwoCell(output));
-    printf("\noutput2 = output + output\n");
-    ByteCell output2 = ByteCellsAdd(output, output);
-    ByteCellPrint(output2); TwoCellPrint(ByteCellToTwoCell(output2));
-    printf("\noutput3 = output2 + output2\n");
-    ByteCell output3 = ByteCellsAdd(output2, output2);
-    ByteCellPrint(output3); TwoCellPrint(ByteCellToTwoCell(output3));
-    printf("\noutput4 = output3 << 8\n");
-    ByteCell output4 = ByteCellShift8Left(output3);
-    ByteCellPrint(output4); TwoCellPrint(ByteCellToTwoCell(output4));
-    printf("\noutput5 = output4 >> 8\n");
-    ByteCell output5 = ByteCellShift8Right(output4);
-    ByteCellPrint(output5); TwoCellPrint(ByteCellToTwoCell(output5));
-    printf("\noutput6 = output * 3\n");
-    ByteCell output6 = ByteCellMultiply(output, 3);
-    ByteCellPrint(output6); TwoCellPrint(ByteCellToTwoCell(output6));
-    printf("\noutput7 = output * output2\n");
-    ByteCell output7 = ByteCellsMultiply(output, output2);
-    ByteCellPrint(output7); TwoCellPrint(ByteCellToTwoCell(output7));
-    printf("\noutput8 = output4 / 128\n");
-    ByteCell output8 = ByteCellDivide(output4, 128);
-    ByteCellPrint(output8); TwoCellPrint(ByteCellToTwoCell(output8));
-}
-// */
+    return quot;
+}
 
 #endif // KF_MATH_H
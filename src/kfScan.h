@@ -0,0 +1,271 @@
+#ifndef KF_SCAN_H
+#define KF_SCAN_H
+
+/*
+ * kfScan.h (last modified 2026-10-18)
+ * This contains the byte scanning kernels used for parsing and comparing
+ * strings: finding delimiters for WORD and PARSE, matching names without
+ * regard to case for FIND, and finding where two strings differ for COMPARE.
+ * They work on 32 bytes at a time with AVX2 or 16 with SSE2, whichever the
+ * compiler targets, and a byte at a time otherwise or when KF_NO_SIMD is
+ * defined. The byte at a time versions are always there, and finish off
+ * whatever's too close to the end of memory for a whole block.
+ */
+
+#include "kfBios.h"
+
+#if defined(KF_NO_SIMD)
+    // Byte at a time only.
+#elif defined(__AVX2__)
+    #include <immintrin.h>
+    #define KF_SCAN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define KF_SCAN_SSE2
+#endif
+
+#if defined(KF_SCAN_AVX2) || defined(KF_SCAN_SSE2)
+    #define KF_SCAN_SIMD
+#endif
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+
+
+// A block can be loaded past the end of a string as long as it doesn't cross
+// into the next page, which might not be mapped. This is the smallest page
+// size of anything with SSE2.
+#define KF_SCAN_PAGE 4096
+
+// How many bytes kfScanSkip and kfScanUntil look at one at a time before
+// switching to blocks. It's twice KF_MAX_NAME_SIZE so that names and numbers
+// never get there, since for them setting up a block costs more than it saves,
+// and only long comments, strings and runs of whitespace do.
+#ifndef KF_SCAN_SHORT
+    #define KF_SCAN_SHORT 32
+#endif
+
+// Loads that are allowed past the end of a string are left alone by ASan,
+// since it would see them as overflows.
+#if defined(__GNUC__) || defined(__clang__)
+    #define KF_SCAN_NO_ASAN __attribute__((no_sanitize_address))
+#else
+    #define KF_SCAN_NO_ASAN
+#endif
+
+
+
+// Byte at a time kernels.
+
+// Whether `c` ends a word that WORD is parsing. When the delimiter is a space,
+// any other whitespace (like the tabs in an included file) counts too.
+bool kfIsDelim(uint8_t c, isize delim) {
+    return c == delim || (delim == ' ' && c < ' ');
+}
+
+uint8_t kfScanFold(uint8_t c) {
+    if (c >= 'A' && c <= 'Z')
+        c += 32;
+    return c;
+}
+
+uint8_t* kfScanSkipScalar(uint8_t* p, uint8_t* end, isize delim) {
+    while (p < end && kfIsDelim(*p, delim))
+        p++;
+    return p;
+}
+
+uint8_t* kfScanUntilScalar(uint8_t* p, uint8_t* end, isize delim) {
+    while (p < end && !kfIsDelim(*p, delim))
+        p++;
+    return p;
+}
+
+bool kfScanEqFoldScalar(uint8_t* a, uint8_t* b, usize len) {
+    for (usize i = 0; i < len; i++) {
+        if (kfScanFold(a[i]) != kfScanFold(b[i]))
+            return false;
+    }
+    return true;
+}
+
+usize kfScanMismatchScalar(uint8_t* a, uint8_t* b, usize len) {
+    usize i = 0;
+    while (i < len && a[i] == b[i])
+        i++;
+    return i;
+}
+
+
+
+// Block operations. Comparisons give 0xFF for each byte where they're true,
+// and kfVecMask packs those into one bit per byte, lowest address first.
+
+#if defined(KF_SCAN_AVX2)
+    typedef __m256i kfVec;
+    #define KF_VEC_SIZE 32
+    #define KF_VEC_ALL  UINT32_MAX
+
+    static inline kfVec kfVecLoad(uint8_t* p) { return _mm256_loadu_si256((__m256i*) p); }
+    KF_SCAN_NO_ASAN
+    static inline kfVec kfVecLoadPart(uint8_t* p) { return _mm256_loadu_si256((__m256i*) p); }
+    static inline kfVec kfVecSplat(uint8_t c) { return _mm256_set1_epi8((char) c); }
+    static inline kfVec kfVecEq(kfVec a, kfVec b) { return _mm256_cmpeq_epi8(a, b); }
+    static inline kfVec kfVecMin(kfVec a, kfVec b) { return _mm256_min_epu8(a, b); }
+    static inline kfVec kfVecSub(kfVec a, kfVec b) { return _mm256_sub_epi8(a, b); }
+    static inline kfVec kfVecAnd(kfVec a, kfVec b) { return _mm256_and_si256(a, b); }
+    static inline kfVec kfVecOr(kfVec a, kfVec b) { return _mm256_or_si256(a, b); }
+    static inline uint32_t kfVecMask(kfVec v) { return (uint32_t) _mm256_movemask_epi8(v); }
+#elif defined(KF_SCAN_SSE2)
+    typedef __m128i kfVec;
+    #define KF_VEC_SIZE 16
+    #define KF_VEC_ALL  0xFFFFu
+
+    static inline kfVec kfVecLoad(uint8_t* p) { return _mm_loadu_si128((__m128i*) p); }
+    KF_SCAN_NO_ASAN
+    static inline kfVec kfVecLoadPart(uint8_t* p) { return _mm_loadu_si128((__m128i*) p); }
+    static inline kfVec kfVecSplat(uint8_t c) { return _mm_set1_epi8((char) c); }
+    static inline kfVec kfVecEq(kfVec a, kfVec b) { return _mm_cmpeq_epi8(a, b); }
+    static inline kfVec kfVecMin(kfVec a, kfVec b) { return _mm_min_epu8(a, b); }
+    static inline kfVec kfVecSub(kfVec a, kfVec b) { return _mm_sub_epi8(a, b); }
+    static inline kfVec kfVecAnd(kfVec a, kfVec b) { return _mm_and_si128(a, b); }
+    static inline kfVec kfVecOr(kfVec a, kfVec b) { return _mm_or_si128(a, b); }
+    static inline uint32_t kfVecMask(kfVec v) { return (uint32_t) _mm_movemask_epi8(v); }
+#endif
+
+#ifdef KF_SCAN_SIMD
+// Unsigned a <= b for each byte.
+static inline kfVec kfVecLe(kfVec a, kfVec b) {
+    return kfVecEq(kfVecMin(a, b), a);
+}
+
+// kfScanFold on each byte.
+static inline kfVec kfVecFold(kfVec v) {
+    kfVec upper = kfVecLe(kfVecSub(v, kfVecSplat('A')), kfVecSplat('Z' - 'A'));
+    return kfVecOr(v, kfVecAnd(upper, kfVecSplat(32)));
+}
+
+// A mask of the first `n` bytes of a block.
+static inline uint32_t kfVecBits(usize n) {
+    return n >= KF_VEC_SIZE ? KF_VEC_ALL : ((uint32_t) 1 << n) - 1;
+}
+
+static inline bool kfVecPageSafe(uint8_t* p) {
+    return ((uintptr_t) p & (KF_SCAN_PAGE - 1)) <= KF_SCAN_PAGE - KF_VEC_SIZE;
+}
+
+// The index of the lowest set bit, which can't be 0.
+static inline usize kfVecFirst(uint32_t m) {
+    #ifdef _MSC_VER
+        unsigned long i;
+        _BitScanForward(&i, m);
+        return i;
+    #else
+        return __builtin_ctz(m);
+    #endif
+}
+
+// Goes a block at a time until it finds a byte that is (or with `skip`, isn't)
+// a `delim`. Returns how far it got, which is where the bytes at a time loop
+// picks up if the end of the string is too close to the end of a page.
+uint8_t* kfScanVec(uint8_t* p, uint8_t* end, isize delim, bool skip) {
+    kfVec k = kfVecSplat((uint8_t) delim);
+    bool space = delim == ' ';
+    while (p < end) {
+        usize left = end - p;
+        kfVec v;
+        if (left >= KF_VEC_SIZE)
+            v = kfVecLoad(p);
+        else if (kfVecPageSafe(p))
+            v = kfVecLoadPart(p);
+        else
+            return p;
+        uint32_t m = kfVecMask(space ? kfVecLe(v, k) : kfVecEq(v, k));
+        if (skip)
+            m = ~m;
+        m &= kfVecBits(left);
+        if (m != 0)
+            return p + kfVecFirst(m);
+        if (left <= KF_VEC_SIZE)
+            return end;
+        p += KF_VEC_SIZE;
+    }
+    return p;
+}
+#endif
+
+
+
+// Kernels.
+
+// Returns the first byte from `p` on that isn't a `delim`, or `end`.
+static inline uint8_t* kfScanSkip(uint8_t* p, uint8_t* end, isize delim) {
+    #ifdef KF_SCAN_SIMD
+        for (usize i = 0; i < KF_SCAN_SHORT; i++, p++) {
+            if (p == end || !kfIsDelim(*p, delim))
+                return p;
+        }
+        if (delim >= 0 && delim <= UINT8_MAX)
+            p = kfScanVec(p, end, delim, true);
+    #endif
+    return kfScanSkipScalar(p, end, delim);
+}
+
+// Returns the first `delim` from `p` on, or `end`.
+static inline uint8_t* kfScanUntil(uint8_t* p, uint8_t* end, isize delim) {
+    #ifdef KF_SCAN_SIMD
+        for (usize i = 0; i < KF_SCAN_SHORT; i++, p++) {
+            if (p == end || kfIsDelim(*p, delim))
+                return p;
+        }
+        if (delim >= 0 && delim <= UINT8_MAX)
+            p = kfScanVec(p, end, delim, false);
+    #endif
+    return kfScanUntilScalar(p, end, delim);
+}
+
+// Whether the `len` bytes at `a` and `b` are the same without regard to case.
+// Names are shorter than a block, so the last block of each is loaded whole
+// when it doesn't cross a page.
+bool kfScanEqFold(uint8_t* a, uint8_t* b, usize len) {
+    #ifdef KF_SCAN_SIMD
+        while (len > 0) {
+            kfVec va, vb;
+            if (len >= KF_VEC_SIZE) {
+                va = kfVecLoad(a);
+                vb = kfVecLoad(b);
+            } else if (kfVecPageSafe(a) && kfVecPageSafe(b)) {
+                va = kfVecLoadPart(a);
+                vb = kfVecLoadPart(b);
+            } else {
+                break;
+            }
+            uint32_t m = ~kfVecMask(kfVecEq(kfVecFold(va), kfVecFold(vb)));
+            if ((m & kfVecBits(len)) != 0)
+                return false;
+            if (len <= KF_VEC_SIZE)
+                return true;
+            a += KF_VEC_SIZE;
+            b += KF_VEC_SIZE;
+            len -= KF_VEC_SIZE;
+        }
+    #endif
+    return kfScanEqFoldScalar(a, b, len);
+}
+
+// Returns the index of the first byte where `a` and `b` differ, or `len`.
+usize kfScanMismatch(uint8_t* a, uint8_t* b, usize len) {
+    usize i = 0;
+    #ifdef KF_SCAN_SIMD
+        for (; len - i >= KF_VEC_SIZE; i += KF_VEC_SIZE) {
+            uint32_t m = ~kfVecMask(kfVecEq(kfVecLoad(a + i), kfVecLoad(b + i))) & KF_VEC_ALL;
+            if (m != 0)
+                return i + kfVecFirst(m);
+        }
+    #endif
+    return i + kfScanMismatchScalar(a + i, b + i, len - i);
+}
+
+#endif // KF_SCAN_H
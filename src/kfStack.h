@@ -2,7 +2,7 @@
 #define KF_STACK_H
 
 /*
- * kfStack.h (last modified 2025-05-27)
+ * kfStack.h (last modified 2026-10-17)
  * The stack file defines the stacks used by kopForth. Specifically the return
  * and data stacks.
  * These stacks grow down and the pointer points to the current "top" value.
@@ -28,8 +28,11 @@ typedef struct kfRetnStack kfRetnStack;
 
 
 
+// The data stack has one extra guard cell past the bottom so the fast inner
+// interpreter, which caches the top item in a local, can always reload it even
+// when the stack is empty. It never holds a real item.
 struct kfDataStack {
-    isize data[KF_DATA_STACK_SIZE];
+    isize data[KF_DATA_STACK_SIZE + 1];
     isize* ptr;
 };
 
@@ -61,6 +64,10 @@ bool kfRetnStackFull(kfRetnStack* r_stack) {
     return r_stack->ptr <= r_stack->data;
 }
 
+isize kfDataStackDepth(kfDataStack* d_stack) {
+    return &d_stack->data[KF_DATA_STACK_SIZE] - d_stack->ptr;
+}
+
 kfStatus kfDataStackPush(kfDataStack* d_stack, isize value) {
     if (kfDataStackFull(d_stack))
         return KF_DATA_STACK_OVERFLOW;
@@ -2,7 +2,7 @@
 #define KF_STATUS_H
 
 /*
- * kfStatus.h (last modified 2025-06-10)
+ * kfStatus.h (last modified 2026-10-17)
  * The status file defines the enum used for debugging and triggering system
  * exceptions.
  */
@@ -38,6 +38,14 @@ typedef enum kfStatus kfStatus;
         STATUS(KF_SYSTEM_COMP_ONLY)     \
         STATUS(KF_SYSTEM_NOT_IMP)       \
         STATUS(KF_SYSTEM_NULL)          \
+        STATUS(KF_MATH_DIV_ZERO)        \
+        STATUS(KF_IMAGE_IO)             \
+        STATUS(KF_IMAGE_BAD)            \
+        STATUS(KF_MEM_FULL)             \
+        STATUS(KF_INCLUDE_IO)           \
+        STATUS(KF_SOURCE_NESTED)        \
+        STATUS(KF_SYSTEM_EVALUATED)     \
+        STATUS(KF_SYSTEM_ABORTED)       \
 
 #define GENERATE_KF_STATUS_ENUM(ENUM)     ENUM,
 #define GENERATE_KF_STATUS_STRING(STRING) #STRING,
@@ -2,7 +2,7 @@
 #define KF_TYPE_H
 
 /*
- * kfType.h (last modified 2025-06-12)
+ * kfType.h (last modified 2026-10-18)
  * This contains the main structs and types used by the kopForth system, along
  * with their helper functions.
  */
@@ -13,7 +13,7 @@
 
 
 // Macros to help with defining words.
-#define WRD(wrd) kopForthAddWordP(forth, wrd)
+#define WRD(wrd) kopForthCompileWord(forth, wrd)
 #define LIT(isz) kopForthAddWordP(forth, forth->debug_words.lit); kopForthAddIsize(forth, (isize) isz)
 #define RAW(isz) kopForthAddIsize(forth, (isize) isz)
 #define WRDADDR(var, wrd) kfWord** var = kopForthAddWordP(forth, wrd)
@@ -28,8 +28,12 @@ typedef struct kopForth       kopForth;
 typedef struct kfWord         kfWord;
 typedef struct kfDebugWords   kfDebugWords;
 typedef struct kfWordBitFlags kfWordBitFlags;
+typedef struct kfFuseRule     kfFuseRule;
+typedef struct kfFoldRule     kfFoldRule;
+typedef struct kfSource       kfSource;
 typedef union  kfWordDef      kfWordDef;
 typedef union  kfWordFlags    kfWordFlags;
+typedef enum   kfPrim         kfPrim;
 
 // This is a function pointer type for native word implementations. It takes a
 // kopForth pointer, does something with it, and returns a status.
@@ -40,6 +44,59 @@ typedef union  kfWordFlags    kfWordFlags;
 // }
 typedef kfStatus (*kfNativeFunc)(kopForth*);
 
+// Tells the direct-threaded inner interpreter how to run a native word. It's
+// stored in the cell right after the native function pointer.
+// Plain natives (KF_PRIM_NONE) are just called. Natives that read or modify
+// the thread through the return stack, like `(S")`, must be added with
+// KF_PRIM_THREAD so the interpreter puts the return address back on the return
+// stack before calling them. The rest are core primitives that the interpreter
+// runs inline instead of calling the native function.
+enum kfPrim {
+    KF_PRIM_NONE,
+    KF_PRIM_THREAD,
+    KF_PRIM_EXT,
+    KF_PRIM_LIT,
+    KF_PRIM_BRA,
+    KF_PRIM_ZBR,
+    KF_PRIM_RPU,
+    KF_PRIM_RPO,
+    KF_PRIM_SUB,
+    KF_PRIM_MUL,
+    KF_PRIM_ATT,
+    KF_PRIM_EXC,
+    KF_PRIM_CAT,
+    KF_PRIM_CEX,
+    KF_PRIM_DRP,
+    KF_PRIM_DUP,
+    KF_PRIM_SWP,
+    KF_PRIM_EQU,
+    KF_PRIM_LSS,
+    KF_PRIM_NAN,
+    KF_PRIM_OVR,
+    KF_PRIM_ROT,
+    KF_PRIM_TDR,
+    KF_PRIM_TDU,
+    KF_PRIM_ADD,
+    KF_PRIM_INV,
+    KF_PRIM_ORR,
+    KF_PRIM_AND,
+    KF_PRIM_XOR,
+    KF_PRIM_LSH,
+    KF_PRIM_RSH,
+    KF_PRIM_ZEQ,
+    KF_PRIM_NEQ,
+    KF_PRIM_LEQ,
+    KF_PRIM_GTR,
+    KF_PRIM_GEQ,
+    KF_PRIM_CLS,
+    KF_PRIM_PEX,
+    KF_PRIM_LAD,
+    KF_PRIM_DZB,
+    KF_PRIM_RRO,
+    KF_PRIM_NIP,
+    KF_PRIM_USR,
+};
+
 
 
 // Special words used by the kopForth debugger and compiler.
@@ -51,6 +108,53 @@ struct kfDebugWords {
     kfWord* typ;
     kfWord* psq;
     kfWord* abt;
+    kfWord* lad;
+    kfWord* dzb;
+    kfWord* usr;
+    kfWord* evl;
+    kfWord* evd;
+};
+
+// How many superinstruction rules COMPILE, checks.
+#define KF_FUSE_RULES 5
+
+// A superinstruction rule for COMPILE,. When `second` gets compiled right after
+// `first` and its `args` inline cells, `first` is swapped for `fused` and
+// `second` isn't compiled, so the inline cells then belong to `fused`.
+struct kfFuseRule {
+    kfWord* first;
+    usize   args;
+    kfWord* second;
+    kfWord* fused;
+};
+
+// How many words COMPILE, can fold when their inputs are literals.
+#define KF_FOLD_RULES 45
+// The most results a folded word can leave (2DUP leaves 4).
+#define KF_FOLD_MAX_OUT 4
+
+// A word that COMPILE, runs at compile time when its `in` inputs are all
+// literals compiled right before it, so they get swapped for the `out` results
+// as literals. Only native words without side effects belong here.
+struct kfFoldRule {
+    kfWord* word;
+    uint8_t in;
+    uint8_t out;
+};
+
+// An input source that was pushed on top of another one, either a file being
+// included or a string being EVALUATEd. A file is mapped into memory, and
+// REFILL makes each of its lines the input source in turn. A string is the
+// input source all at once, so REFILL has nothing for it. The input source it
+// was pushed on top of gets restored when it ends.
+struct kfSource {
+    uint8_t*     data;              // The contents of the file, or NULL for a string.
+    usize        len;               // The size of the file in bytes.
+    usize        next;              // The offset of the next line in `data`.
+    uint8_t*     source;            // The input source below this one.
+    usize        source_len;        // Its length.
+    usize        in_offset;         // Its >IN.
+    isize        source_id;         // Its SOURCE-ID.
 };
 
 // This is the main struct from which an instance of kopForth is created.
@@ -62,16 +166,44 @@ struct kopForth {
     kfWord*      pending;           // Pointer to the most recently defined word, but not necessarily the latest active word.
     isize        state;             // The compilation state, true=compiling, false=interpret. Uses `isize` so Forth programs can just use `@` and `!`.
     isize        debug;             // The debug state, true=enabled, false=disabled. Uses `isize` so Forth programs can just use `@` and `!`.
+    isize        base;              // The radix numbers are read and printed in.
     uint8_t*     pc;                // Program counter for forth inner loop.
     kfDebugWords debug_words;       // Pointers to words used by the kopForth debugger and compiler.
+    kfWord**     cpl_last;          // Where COMPILE, put the last instruction, or NULL if nothing can be fused with it.
+    kfWord**     cpl_lits;          // Where the run of (LIT)s that ends at `cpl_last` starts, or NULL if it's not a (LIT).
+    kfWord**     cpl_tail;          // Where `;` last put a tail call branch, so INLINE can put the call back.
+    kfFuseRule   fuse_rules[KF_FUSE_RULES];  // The superinstructions COMPILE, looks for.
+    kfFoldRule   fold_rules[KF_FOLD_RULES];  // The words COMPILE, folds.
+    kfWord*      exec[2];           // A two word thread that EXECUTE runs its xt through, the second word is EXIT.
+    uint8_t*     kernel;            // The prebuilt kernel or the parent's dictionary, or NULL if the kernel was built in `mem`.
+    usize        kernel_size;       // The size of the kernel in bytes.
+    kopForth*    parent;            // The system this was cloned from, or NULL.
+    kfWord*      host;              // The word kopForthEvaluate returns into, which stops the system.
+    bool         host_eval;         // Whether kopForthEvaluate is running.
     // Heap
-    uint8_t      mem[KF_MEM_SIZE];  // The general memory space where the word dictionary is held.
+    uint8_t*     mem;               // The general memory space where the word dictionary is held. It's reserved up front and committed as it fills.
+    usize        mem_size;          // How many bytes of `mem` can be used, not counting the headroom after it.
+    usize        mem_committed;     // How many bytes of `mem` are committed so far.
     // Stacks + bufs
     kfDataStack  d_stack;           // The data stack.
-    usize        in_offset;         // The index for the next character to read from the TIB.
+    uint8_t*     source;            // The input being parsed, either `tib`, a line of an included file, or an EVALUATEd string.
+    usize        source_len;        // The length of `source`.
+    usize        in_offset;         // The index for the next character to read from `source`.
+    isize        source_id;         // The SOURCE-ID of `source`, 0 for the user's input, -1 for a string, or else a fileid.
     usize        tib_len;           // The total size of the text in the TIB.
     uint8_t      tib[KF_TIB_SIZE];  // The terminal input buffer.
+    usize        source_depth;      // How many input sources are on top of the user's input.
+    kfSource     sources[KF_SOURCE_DEPTH];  // The input sources on top of the user's input, innermost last.
+    usize        included_count;    // How many names are in `included`.
+    usize        included[KF_INCLUDED_SIZE];  // Hashes of the names of the files INCLUDED, for REQUIRED.
     kfRetnStack  r_stack;           // The return stack.
+    #ifdef KF_HASHED_FIND
+    // Dictionary index
+    kfWord*      hash_latest;                // The `latest` word that `hash` was last synced to.
+    bool         hash_clear;                 // Whether `hash` has been cleared since the system started.
+    usize        hash_count;                 // The number of words in `hash`.
+    kfWord*      hash[KF_FIND_HASH_SIZE];    // Open addressing hash table of the visible words, by name.
+    #endif
 };
 
 // This is the type that actually defines what the word does. It either calls a
@@ -88,6 +220,7 @@ union kfWordDef {
 struct kfWordBitFlags {
     uint8_t   is_native    : 1;  // Determines if the word points to a function or a list of words.
     uint8_t   is_immediate : 1;  // Determines if the word is executed at compile time.
+    uint8_t   is_inline    : 1;  // Determines if the compiler copies the word's body into callers instead of calling it.
 };
 
 union kfWordFlags {
@@ -111,21 +244,148 @@ struct kfWord {
 
 // Helper functions for defining words and stuff in kopForth.
 
+kfPrim kfNativePrim(kfWord* word) {
+    return (kfPrim) (isize) word->word_def.forth[1];
+}
+
+kfWord** kfWordBody(kfWord* word) {
+    return (kfWord**) ((uint8_t*) word + sizeof(kfWord) - sizeof(kfWordDef));
+}
+
+// The number of bytes of inline data that follow a word in a thread.
+usize kfThreadArgSize(kopForth* forth, kfWord* word) {
+    kfDebugWords* dw = &forth->debug_words;
+    if (word == dw->lit || word == dw->bra || word == dw->zbr ||
+        word == dw->lad || word == dw->dzb || word == dw->usr)
+        return sizeof(isize);
+    return 0;
+}
+
+// Checks if a colon word whose definition ends at `end` can be copied into its
+// callers in place of calling it. It has to end in its only EXIT, and can't
+// branch, touch the return stack or the thread, or point into its own body
+// (like EXIT-ing EXECUTE does). It also can't call a colon word that isn't
+// inlined itself, since that word could reach into its caller's frame with R>
+// and would find the wrong one once the body is copied. Unless `any_size` is
+// set, it also has to be no more than KF_INLINE_SIZE cells long, not counting
+// the EXIT.
+bool kfInlineCheck(kopForth* forth, kfWord* word, uint8_t* end, bool any_size) {
+    if (word == NULL || word->flags.bit_flags.is_native ||
+        forth->debug_words.ext == NULL)
+        return false;
+    kfWord** body = kfWordBody(word);
+    if ((uint8_t*) body >= end || (end - (uint8_t*) body) % sizeof(kfWord*) != 0)
+        return false;
+    kfWord** exit = (kfWord**) end - 1;
+    if (*exit != forth->debug_words.ext)
+        return false;
+    if (!any_size && exit - body > KF_INLINE_SIZE)
+        return false;
+    for (kfWord** cell = body; cell < exit; cell++) {
+        kfWord* xt = *cell;
+        if (xt == NULL || xt == forth->debug_words.ext)
+            return false;
+        if (xt->flags.bit_flags.is_native) {
+            switch (kfNativePrim(xt)) {
+                case KF_PRIM_THREAD:
+                case KF_PRIM_BRA:
+                case KF_PRIM_ZBR:
+                case KF_PRIM_DZB:
+                case KF_PRIM_RPU:
+                case KF_PRIM_RPO:
+                case KF_PRIM_RRO:
+                    return false;
+                default:
+                    break;
+            }
+        } else if (!xt->flags.bit_flags.is_inline) {
+            return false;
+        }
+        if (kfThreadArgSize(forth, xt) != 0) {
+            cell++;
+            uint8_t* arg = *(uint8_t**) cell;
+            if (arg >= (uint8_t*) body && arg < end)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool kfInMem(kopForth* forth, void* ptr) {
+    return (uint8_t*) ptr >= forth->mem && (uint8_t*) ptr < forth->mem + forth->mem_size;
+}
+
+// Checks if the pointer is in the kernel, or right at the end of it.
+bool kfInKernel(kopForth* forth, void* ptr) {
+    return forth->kernel != NULL && (uint8_t*) ptr >= forth->kernel &&
+           (uint8_t*) ptr <= forth->kernel + forth->kernel_size;
+}
+
+// Finds the end of the part of the dictionary that `ptr` is in. That's HERE for
+// `mem`, or the end of the kernel, which for a clone is the end of its parent's
+// dictionary and can have the parent's kernel below it.
+uint8_t* kfRegionEnd(kopForth* forth, void* ptr) {
+    for (; forth != NULL; forth = forth->parent) {
+        if (kfInMem(forth, ptr))
+            return forth->here;
+        if (kfInKernel(forth, ptr))
+            return forth->kernel + forth->kernel_size;
+    }
+    return NULL;
+}
+
+// Sets whether a finished definition can be inlined. Words marked with INLINE
+// can be any size. Words in a prebuilt kernel were already decided.
+void kfInlineClose(kopForth* forth, kfWord* word, uint8_t* end) {
+    if (word == NULL || word->flags.bit_flags.is_native || !kfInMem(forth, word))
+        return;
+    bool any_size = word->flags.bit_flags.is_inline;
+    word->flags.bit_flags.is_inline = kfInlineCheck(forth, word, end, any_size);
+}
+
+// Commits enough of `mem` for `length` more bytes at HERE, plus the headroom.
+// It's committed KF_MEM_COMMIT_SIZE bytes at a time so growing is rare.
+bool kfMemCommit(kopForth* forth, usize length) {
+    usize need = (forth->here - forth->mem) + length + KF_MEM_HEADROOM;
+    if (need <= forth->mem_committed)
+        return true;
+    usize end = (need + KF_MEM_COMMIT_SIZE - 1) / KF_MEM_COMMIT_SIZE * KF_MEM_COMMIT_SIZE;
+    if (end > forth->mem_size + KF_MEM_HEADROOM)
+        end = forth->mem_size + KF_MEM_HEADROOM;
+    if (!kfBiosMemCommit(forth->mem, forth->mem_committed, end))
+        return false;
+    forth->mem_committed = end;
+    return true;
+}
+
 bool kfCanFitInMem(kopForth* forth, usize length) {
-    uint8_t* new_next_mem_ptr = forth->here + length;
-    return new_next_mem_ptr <= forth->mem + KF_MEM_SIZE;
+    usize used = forth->here - forth->mem;
+    if (used > forth->mem_size || length > forth->mem_size - used)
+        return false;
+    return kfMemCommit(forth, length);
 }
 
 kfWord* kopForthCreateWord(kopForth* forth) {
     kfWord* word = (kfWord*) forth->here;
     if (!kfCanFitInMem(forth, sizeof(kfWord)))
         return NULL;
+    kfInlineClose(forth, forth->pending, forth->here);
+    #ifdef KF_HASHED_FIND
+        // New words always go above the old ones, unless DP was rolled back. A
+        // word made then can land on a word the index still has, and keep it
+        // from seeing that anything changed, so it's rebuilt on the next FIND.
+        if (kfInMem(forth, forth->hash_latest) && word <= forth->hash_latest) {
+            forth->hash_latest = NULL;
+            forth->hash_clear = false;
+        }
+    #endif
     forth->here += sizeof(kfWord) - sizeof(kfWordDef);
     forth->latest = forth->pending;
     word->link = forth->latest;
     forth->pending = word;
     word->flags.bit_flags.is_native = false;
     word->flags.bit_flags.is_immediate = false;
+    word->flags.bit_flags.is_inline = false;
     return word;
 }
 
@@ -163,23 +423,62 @@ kfWord** kopForthAddWordP(kopForth* forth, kfWord* value) {
     return ptr;
 }
 
-kfWord* kopForthAddNativeWord(kopForth* forth, char* name, kfNativeFunc func_ptr,
-                              bool is_immediate) {
-    if (!kfCanFitInMem(forth, sizeof(kfWord)))
+kfWord* kopForthAddPrimWord(kopForth* forth, char* name, kfNativeFunc func_ptr,
+                            bool is_immediate, kfPrim prim) {
+    if (!kfCanFitInMem(forth, sizeof(kfWord) + sizeof(isize)))
         return NULL;
     kfWord* word = kopForthAddWord(forth, name);
     word->flags.bit_flags.is_native = true;
     word->flags.bit_flags.is_immediate = is_immediate;
     kopForthAddIsize(forth, (isize) func_ptr);
+    kopForthAddIsize(forth, (isize) prim);
     return word;
 }
 
+kfWord* kopForthAddNativeWord(kopForth* forth, char* name, kfNativeFunc func_ptr,
+                              bool is_immediate) {
+    return kopForthAddPrimWord(forth, name, func_ptr, is_immediate, KF_PRIM_NONE);
+}
+
+// Returns how many cells of a word's body (not counting the EXIT) get copied
+// into callers, or -1 if it gets called instead.
+isize kfInlineCells(kopForth* forth, kfWord* word) {
+    if (word == NULL || word->flags.bit_flags.is_native ||
+        !word->flags.bit_flags.is_inline)
+        return -1;
+    kfWord** body = kfWordBody(word);
+    kfWord** cell = body;
+    while (*cell != forth->debug_words.ext)
+        cell += 1 + kfThreadArgSize(forth, *cell) / sizeof(kfWord*);
+    return cell - body;
+}
+
+// Compiles a call to a word, or a copy of its body if it can be inlined.
+// Returns where it was compiled, like kopForthAddWordP.
+kfWord** kopForthCompileWord(kopForth* forth, kfWord* word) {
+    isize cells = kfInlineCells(forth, word);
+    if (cells < 0)
+        return kopForthAddWordP(forth, word);
+    kfWord** start = (kfWord**) forth->here;
+    kfWord** cell = kfWordBody(word);
+    kfWord** end = cell + cells;
+    while (cell < end) {
+        kfWord* xt = *cell++;
+        kopForthCompileWord(forth, xt);
+        if (kfThreadArgSize(forth, xt) != 0)
+            kopForthAddIsize(forth, *(isize*) cell++);
+    }
+    return start;
+}
+
+// Variables point at a field of the kopForth struct. They're compiled as an
+// offset from the struct, so the word doesn't depend on where the struct is.
 kfWord* kopForthAddVariable(kopForth* forth, char* name, isize* var_ptr) {
     if (!kfCanFitInMem(forth, sizeof(kfWord) + 2 * sizeof(kfWord*)))
         return NULL;
     kfWord* word = kopForthAddWord(forth, name);
-    kopForthAddWordP(forth, forth->debug_words.lit);
-    kopForthAddIsize(forth, (isize) var_ptr);
+    kopForthAddWordP(forth, forth->debug_words.usr);
+    kopForthAddIsize(forth, (isize) ((uint8_t*) var_ptr - (uint8_t*) forth));
     kopForthAddWordP(forth, forth->debug_words.ext);
     return word;
 }
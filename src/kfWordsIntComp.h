@@ -2,10 +2,15 @@
 #define KF_WORDS_INT_COMP_H
 
 /*
- * kfWordsIntComp.h (last modified 2025-06-04)
+ * kfWordsIntComp.h (last modified 2026-10-18)
  * This contains the word definitions for the shell interpreter and compiler.
+ * COMPILE, fuses some common pairs of words into native superinstructions and
+ * folds pure words on literals, see kfPopulateWordsIntComp for the lists.
  */
 
+#include "kfDict.h"
+#include "kfStack.h"
+#include "kfStatus.h"
 #include "kfType.h"
 #include "kfWordsNative.h"
 #include "kfWordsStackMem.h"
@@ -17,6 +22,15 @@
 // Pointers to words created in this file, for usage in defining other words.
 typedef struct kfWordsIntComp kfWordsIntComp;
 struct kfWordsIntComp {
+    kfWord* lad;
+    kfWord* dzb;
+    kfWord* ovo;
+    kfWord* rro;
+    kfWord* nip;
+    kfWord* frs;
+    kfWord* tex;
+    kfWord* inl;
+    kfWord* fsd;
     kfWord* src;
     kfWord* rfl;
     kfWord* exe;
@@ -29,37 +43,666 @@ struct kfWordsIntComp {
     kfWord* col;
     kfWord* sem;
     kfWord* inp;
+    kfWord* sid;
+    kfWord* prs;
+    kfWord* pnm;
+    kfWord* fnm;
+    kfWord* pfn;
+    kfWord* cmt;
+    kfWord* bsl;
+    kfWord* ifl;
+    kfWord* ind;
+    kfWord* sen;
+    kfWord* idq;
+    kfWord* srs;
+    kfWord* evs;
+    kfWord* evd;
+    kfWord* ilp;
+    kfWord* inf;
+    kfWord* icd;
+    kfWord* req;
+    kfWord* icl;
+    kfWord* rqr;
+    kfWord* evl;
     kfWord* qut;
-    //kfWord* evl;
     //kfWord* pst;
 };
 
 
 
+// Superinstructions that COMPILE, fuses word pairs into.
+
+kfStatus W_Lad(kopForth* forth) {  // n1 -- n2
+    isize* lit_val;
+    isize a;
+    KF_RETN_POP(lit_val);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a + *lit_val);
+    lit_val++;
+    KF_RETN_PUSH(lit_val);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Dzb(kopForth* forth) {  // n -- n
+    void* a;
+    isize b;
+    KF_RETN_POP(a);
+    KF_DATA_POP(b);
+    KF_DATA_PUSH(b);
+    if (b == 0) {
+        a = *(void**) a;
+    } else {
+        a += sizeof(kfWord*);
+    }
+    KF_RETN_PUSH(a);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Ovo(kopForth* forth) {  // n1 n2 -- n1 n2 n1 n2
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a);
+    KF_DATA_PUSH(b);
+    KF_DATA_PUSH(a);
+    KF_DATA_PUSH(b);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Rro(kopForth* forth) {  // -- n1 n2
+    isize a, b;
+    void* c;
+    KF_RETN_POP(c);
+    KF_RETN_POP(a);
+    KF_RETN_POP(b);
+    KF_DATA_PUSH(a);
+    KF_DATA_PUSH(b);
+    KF_RETN_PUSH(c);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Nip(kopForth* forth) {  // n1 n2 -- n2
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(b);
+    return KF_STATUS_OK;
+}
+
+// The number of (LIT)s compiled back to back right before HERE.
+usize kfLitRun(kopForth* forth) {
+    kfWord** last = forth->cpl_last;
+    if (forth->cpl_lits == NULL || last == NULL ||
+        *last != forth->debug_words.lit || (uint8_t*) (last + 2) != forth->here)
+        return 0;
+    return (last + 2 - forth->cpl_lits) / 2;
+}
+
+// Runs a word from the fold rules at compile time if all of its inputs are
+// literals that were just compiled, and swaps those literals for its results.
+// Returns false if the word has to be compiled as usual.
+bool kfFold(kopForth* forth, kfWord* xt) {
+    if (!xt->flags.bit_flags.is_native)
+        return false;
+    kfFoldRule* rule = NULL;
+    for (usize i = 0; i < KF_FOLD_RULES; i++) {
+        if (forth->fold_rules[i].word == xt)
+            rule = &forth->fold_rules[i];
+    }
+    if (rule == NULL || kfLitRun(forth) < rule->in)
+        return false;
+    kfWord** start = (kfWord**) forth->here - 2 * rule->in;
+    if (rule->out > rule->in &&
+        !kfCanFitInMem(forth, 2 * (rule->out - rule->in) * sizeof(kfWord*)))
+        return false;
+
+    // Run it on top of whatever is on the stack, then put the stack back.
+    kfDataStack* d_stack = &forth->d_stack;
+    isize* bottom = d_stack->ptr;
+    for (usize i = 0; i < rule->in; i++) {
+        if (!kfStatusIsOk(kfDataStackPush(d_stack, *(isize*) (start + 2 * i + 1)))) {
+            d_stack->ptr = bottom;
+            return false;
+        }
+    }
+    kfStatus s = xt->word_def.native(forth);
+    if (!kfStatusIsOk(s) || d_stack->ptr != bottom - rule->out) {
+        d_stack->ptr = bottom;
+        return false;
+    }
+    isize results[KF_FOLD_MAX_OUT];
+    for (usize i = rule->out; i > 0; i--)
+        kfDataStackPop(d_stack, &results[i - 1]);
+
+    forth->here = (uint8_t*) start;
+    for (usize i = 0; i < rule->out; i++) {
+        forth->cpl_last = kopForthAddWordP(forth, forth->debug_words.lit);
+        kopForthAddIsize(forth, results[i]);
+    }
+    if (rule->out == 0) {
+        if (start == forth->cpl_lits) {
+            forth->cpl_last = NULL;
+            forth->cpl_lits = NULL;
+        } else {
+            forth->cpl_last = start - 2;
+        }
+    }
+    return true;
+}
+
+// Compiles an xt, or fuses it with the previous instruction if there's a rule
+// for that pair. The previous instruction only counts if nothing else has been
+// compiled since it, and it's forgotten whenever an immediate word runs (like
+// one that resolves a branch to HERE) so a branch target never ends up in the
+// middle of a superinstruction.
+// Pure words whose inputs are all literals get folded into literals first, see
+// kfFold, and short colon words get their bodies copied in, see kfInlineCells.
+kfStatus kfCompile(kopForth* forth, kfWord* xt) {
+    if (kfFold(forth, xt))
+        return KF_STATUS_OK;
+    kfWord** last = forth->cpl_last;
+    if (last != NULL) {
+        for (usize i = 0; i < KF_FUSE_RULES; i++) {
+            kfFuseRule* rule = &forth->fuse_rules[i];
+            if (rule->second == xt && *last == rule->first &&
+                (uint8_t*) (last + 1 + rule->args) == forth->here) {
+                // Without KF_NATIVE_STACK_MEM `+` isn't native so it can't be
+                // folded, but (LIT) a (LIT) b + is still just (LIT) a+b.
+                if (rule->fused == forth->debug_words.lad && kfLitRun(forth) >= 2) {
+                    *(isize*) (last - 1) += *(isize*) (last + 1);
+                    forth->here = (uint8_t*) last;
+                    forth->cpl_last = last - 2;
+                    return KF_STATUS_OK;
+                }
+                *last = rule->fused;
+                return KF_STATUS_OK;
+            }
+        }
+    }
+    isize cells = kfInlineCells(forth, xt);
+    if (cells >= 0) {
+        kfWord** cell = kfWordBody(xt);
+        kfWord** end = cell + cells;
+        while (cell < end) {
+            kfWord* sub = *cell++;
+            KF_RETURN_IF_ERROR(kfCompile(forth, sub));
+            if (kfThreadArgSize(forth, sub) != 0) {
+                if (kopForthAddIsize(forth, *(isize*) cell++) == NULL)
+                    return KF_SYSTEM_NULL;
+            }
+        }
+        return KF_STATUS_OK;
+    }
+    kfWord** here = (kfWord**) forth->here;
+    if (xt != forth->debug_words.lit)
+        forth->cpl_lits = NULL;
+    else if (kfLitRun(forth) == 0)
+        forth->cpl_lits = here;
+    forth->cpl_last = here;
+    if (kopForthAddWordP(forth, xt) == NULL)
+        return KF_SYSTEM_NULL;
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Cpl(kopForth* forth) {  // xt --
+    kfWord* xt;
+    KF_DATA_POP(xt);
+    return kfCompile(forth, xt);
+}
+
+// Runs the xt by returning into `exec`, whose EXIT then returns to the caller.
+// This keeps EXECUTE from having to write the xt into its own body.
+kfStatus W_Exe(kopForth* forth) {  // xt --
+    kfWord* xt;
+    KF_DATA_POP(xt);
+    forth->exec[0] = xt;
+    forth->exec[1] = forth->debug_words.ext;
+    KF_RETN_PUSH(forth->exec);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Frs(kopForth* forth) {  // --
+    forth->cpl_last = NULL;
+    forth->cpl_lits = NULL;
+    return KF_STATUS_OK;
+}
+
+// Ends a definition. If the last instruction is a call to a colon word, it gets
+// turned into a branch to that word's body instead, which then returns straight
+// to our caller. Otherwise EXIT is compiled.
+// Definitions short enough to be inlined keep their call and EXIT, since their
+// callers won't be calling them anyway.
+kfStatus W_Tex(kopForth* forth) {  // --
+    kfWord** last = forth->cpl_last;
+    if (last != NULL && (uint8_t*) (last + 1) == forth->here &&
+        !(*last)->flags.bit_flags.is_native) {
+        kfWord* callee = *last;
+        if (kopForthAddWordP(forth, forth->debug_words.ext) == NULL)
+            return KF_SYSTEM_NULL;
+        if (kfInlineCheck(forth, forth->pending, forth->here, false)) {
+            forth->pending->flags.bit_flags.is_inline = true;
+            return KF_STATUS_OK;
+        }
+        *last = forth->debug_words.bra;
+        *(last + 1) = (kfWord*) kfWordBody(callee);
+        forth->cpl_last = NULL;
+        forth->cpl_tail = last;
+        return KF_STATUS_OK;
+    }
+    KF_RETURN_IF_ERROR(kfCompile(forth, forth->debug_words.ext));
+    kfInlineClose(forth, forth->pending, forth->here);
+    return KF_STATUS_OK;
+}
+
+// Marks the latest definition so the compiler inlines it no matter its size, as
+// long as it doesn't branch or touch the return stack. A tail call that `;`
+// made gets turned back into a call so the word can still be inlined.
+kfStatus W_Inl(kopForth* forth) {  // --
+    kfWord* word = forth->pending;
+    kfWord** tail = forth->cpl_tail;
+    if (tail != NULL && (uint8_t*) (tail + 2) == forth->here &&
+        tail >= kfWordBody(word)) {
+        *tail = (kfWord*) ((uint8_t*) *(tail + 1) - sizeof(kfWord) + sizeof(kfWordDef));
+        *(tail + 1) = forth->debug_words.ext;
+    }
+    forth->cpl_tail = NULL;
+    word->flags.bit_flags.is_inline = true;
+    kfInlineClose(forth, word, forth->here);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Fsd(kopForth* forth) {  // "name" --
+    usize len;
+    uint8_t* name = kfParseName(forth, &len);
+    kfWord* word = kfFindName(forth, name, len);
+    if (word == NULL) {
+        kfBiosWriteStr("Word not found");
+        return KF_STATUS_OK;
+    }
+    if (word->flags.bit_flags.is_native)
+        return KF_STATUS_OK;
+    // The definition ends where the next word starts, or with the part of the
+    // dictionary it's in.
+    uint8_t* end = kfRegionEnd(forth, word);
+    for (kfWord* next = forth->pending; next != NULL; next = next->link) {
+        if (next->link == word) {
+            if ((uint8_t*) next > (uint8_t*) word && (uint8_t*) next < end)
+                end = (uint8_t*) next;
+            break;
+        }
+    }
+    uint8_t* cell = (uint8_t*) word->word_def.forth;
+    while (cell + sizeof(kfWord*) <= end) {
+        kfWord* xt = *(kfWord**) cell;
+        cell += sizeof(kfWord*);
+        for (usize i = 0; i < KF_FUSE_RULES; i++) {
+            if (xt == forth->fuse_rules[i].fused) {
+                kfBiosWriteStrLen(xt->name, xt->name_len);
+                kfBiosWriteChar(' ');
+                break;
+            }
+        }
+        if (xt == forth->debug_words.psq)
+            cell += 1 + *cell;
+        else
+            cell += kfThreadArgSize(forth, xt);
+    }
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Src(kopForth* forth) {  // -- addr u
+    KF_DATA_PUSH(forth->source);
+    KF_DATA_PUSH(forth->source_len);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Sid(kopForth* forth) {  // -- n
+    KF_DATA_PUSH(forth->source_id);
+    return KF_STATUS_OK;
+}
+
+// PARSE and PARSE-NAME leave the text where it is in the input source instead
+// of copying it to HERE like WORD does.
+kfStatus W_Prs(kopForth* forth) {  // char -- addr u
+    isize c;
+    usize len;
+    KF_DATA_POP(c);
+    uint8_t* addr = kfParse(forth, c, &len);
+    KF_DATA_PUSH(addr);
+    KF_DATA_PUSH(len);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Pnm(kopForth* forth) {  // -- addr u
+    usize len;
+    uint8_t* addr = kfParseName(forth, &len);
+    KF_DATA_PUSH(addr);
+    KF_DATA_PUSH(len);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Fnm(kopForth* forth) {  // addr u -- nt | 0
+    uint8_t* addr;
+    usize len;
+    KF_DATA_POP(len);
+    KF_DATA_POP(addr);
+    KF_DATA_PUSH(kfFindName(forth, addr, len));
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Cmt(kopForth* forth) {  // "ccc<paren>" --
+    usize len;
+    kfParse(forth, ')', &len);
+    return KF_STATUS_OK;
+}
+
+// The input source is usually one line, but a string given to EVALUATE can
+// have several, and only the rest of the current one is skipped.
+kfStatus W_Bsl(kopForth* forth) {  // "ccc<eol>" --
+    usize len;
+    kfParse(forth, '\n', &len);
+    return KF_STATUS_OK;
+}
+
+// FIND for a string that's still in the input source, which INTERPRET uses.
+kfStatus W_Pfn(kopForth* forth) {  // addr u -- addr u 0 | xt 1 | xt -1
+    uint8_t* addr;
+    usize len;
+    KF_DATA_POP(len);
+    KF_DATA_POP(addr);
+    kfWord* word = kfFindName(forth, addr, len);
+    if (word == NULL) {
+        KF_DATA_PUSH(addr);
+        KF_DATA_PUSH(len);
+        KF_DATA_PUSH(0);
+        return KF_STATUS_OK;
+    }
+    KF_DATA_PUSH(word);
+    KF_DATA_PUSH(word->flags.bit_flags.is_immediate ? 1 : -1);
+    return KF_STATUS_OK;
+}
+
+
+
+// The input source stack. Included files and EVALUATEd strings get pushed on
+// top of the user's input, see kfSource. A file is mapped whole, and each of
+// its lines is parsed right out of the mapping, and a string is parsed where
+// it is, so neither gets copied into the TIB.
+
+// Pushes an input source on top of the current one. `data` is the `len` bytes
+// of a mapped file, which kfSourcePop unmaps, or NULL to make the `len` bytes
+// at `source` the input source instead.
+kfStatus kfSourcePush(kopForth* forth, uint8_t* data, usize len, uint8_t* source,
+                      isize source_id) {
+    if (forth->source_depth == KF_SOURCE_DEPTH) {
+        if (data != NULL)
+            kfBiosFileUnmap(data, len);
+        return KF_SOURCE_NESTED;
+    }
+    kfSource* src = &forth->sources[forth->source_depth++];
+    src->data = data;
+    src->len = data != NULL ? len : 0;
+    src->next = 0;
+    src->source = forth->source;
+    src->source_len = forth->source_len;
+    src->in_offset = forth->in_offset;
+    src->source_id = forth->source_id;
+    forth->source = data != NULL ? data : source;
+    forth->source_len = data != NULL ? 0 : len;
+    forth->in_offset = 0;
+    forth->source_id = source_id;
+    return KF_STATUS_OK;
+}
+
+// Ends the innermost input source and goes back to the one below it.
+void kfSourcePop(kopForth* forth) {
+    kfSource* src = &forth->sources[--forth->source_depth];
+    if (src->data != NULL)
+        kfBiosFileUnmap(src->data, src->len);
+    forth->source = src->source;
+    forth->source_len = src->source_len;
+    forth->in_offset = src->in_offset;
+    forth->source_id = src->source_id;
+}
+
+// Makes the next line of the innermost file the input source. Returns false at
+// the end of the file, or right away for a string.
+bool kfSourceRefill(kopForth* forth) {
+    kfSource* src = &forth->sources[forth->source_depth - 1];
+    if (src->next >= src->len)
+        return false;
+    uint8_t* line = src->data + src->next;
+    usize avail = src->len - src->next;
+    uint8_t* nl = memchr(line, '\n', avail);
+    usize len = nl != NULL ? (usize) (nl - line) : avail;
+    src->next += nl != NULL ? len + 1 : len;
+    if (len > 0 && line[len - 1] == '\r')
+        len--;
+    forth->source = line;
+    forth->source_len = len;
+    forth->in_offset = 0;
+    return true;
+}
+
+// Maps an open file and starts including it.
+kfStatus kfIncludeFile(kopForth* forth, void* file) {
+    usize len;
+    uint8_t* data = kfBiosFileMap(file, &len);
+    if (data == NULL)
+        return KF_INCLUDE_IO;
+    return kfSourcePush(forth, data, len, NULL, (isize) file);
+}
+
+// The FNV-1a hash of a file name, which is what REQUIRED remembers files by.
+usize kfIncludeHash(uint8_t* name, usize len) {
+    usize hash = (usize) 2166136261u;
+    for (usize i = 0; i < len; i++)
+        hash = (hash ^ name[i]) * 16777619u;
+    return hash;
+}
+
+bool kfIncludeWasIncluded(kopForth* forth, uint8_t* name, usize len) {
+    usize hash = kfIncludeHash(name, len);
+    for (usize i = 0; i < forth->included_count; i++) {
+        if (forth->included[i] == hash)
+            return true;
+    }
+    return false;
+}
+
+// Reads the next line of the innermost input source, or of the user's input,
+// and starts parsing it from the beginning. Leaves false at the end of a file
+// or the user's input, and for a string. Batch input is parsed right where the
+// bios buffered it, and terminal input is read into TIB and followed by a
+// space, since the user's return isn't echoed.
+kfStatus W_Rfl(kopForth* forth) {  // -- f
+    if (forth->source_depth > 0) {
+        KF_DATA_PUSH(kfSourceRefill(forth) ? -1 : 0);
+        return KF_STATUS_OK;
+    }
+    if (kfBiosIsBatch()) {
+        char* line;
+        isize len = kfBiosReadLine(&line);
+        if (len < 0) {
+            KF_DATA_PUSH(0);
+            return KF_STATUS_OK;
+        }
+        forth->source = (uint8_t*) line;
+        forth->source_len = len;
+        forth->in_offset = 0;
+        KF_DATA_PUSH(-1);
+        return KF_STATUS_OK;
+    }
+    isize len = kfAccept(forth->tib, KF_TIB_SIZE);
+    if (len < 0) {
+        KF_DATA_PUSH(0);
+        return KF_STATUS_OK;
+    }
+    forth->tib_len = len;
+    forth->source = forth->tib;
+    forth->source_len = len;
+    forth->in_offset = 0;
+    kfBiosWriteChar(' ');
+    KF_DATA_PUSH(-1);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Ifl(kopForth* forth) {  // fileid --
+    void* file;
+    KF_DATA_POP(file);
+    return kfIncludeFile(forth, file);
+}
+
+// Opens, maps, and closes the named file, and starts including it.
+kfStatus W_Ind(kopForth* forth) {  // addr u --
+    uint8_t* addr;
+    usize u;
+    KF_DATA_POP(u);
+    KF_DATA_POP(addr);
+    void* file = kfBiosFileOpen((char*) addr, u, false);
+    if (file == NULL)
+        return KF_INCLUDE_IO;
+    kfStatus status = kfIncludeFile(forth, file);
+    kfBiosFileClose(file);
+    KF_RETURN_IF_ERROR(status);
+    // Once the table is full, REQUIRED just includes files again.
+    if (!kfIncludeWasIncluded(forth, addr, u) && forth->included_count < KF_INCLUDED_SIZE)
+        forth->included[forth->included_count++] = kfIncludeHash(addr, u);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Sen(kopForth* forth) {  // --
+    if (forth->source_depth > 0)
+        kfSourcePop(forth);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Idq(kopForth* forth) {  // addr u -- addr u f
+    uint8_t* addr;
+    usize u;
+    KF_DATA_POP(u);
+    KF_DATA_POP(addr);
+    KF_DATA_PUSH(addr);
+    KF_DATA_PUSH(u);
+    KF_DATA_PUSH(kfIncludeWasIncluded(forth, addr, u) ? -1 : 0);
+    return KF_STATUS_OK;
+}
+
+// Ends every input source and makes the user's input the input source again.
+// When the host is running kopForthEvaluate, this stops the system instead so
+// kopForthEvaluate can put things back the way they were.
+kfStatus W_Srs(kopForth* forth) {  // --
+    if (forth->host_eval)
+        return KF_SYSTEM_ABORTED;
+    while (forth->source_depth > 0)
+        kfSourcePop(forth);
+    forth->source = forth->tib;
+    forth->source_len = 0;
+    forth->in_offset = 0;
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Evs(kopForth* forth) {  // addr u --
+    uint8_t* addr;
+    usize u;
+    KF_DATA_POP(u);
+    KF_DATA_POP(addr);
+    return kfSourcePush(forth, NULL, u, addr, -1);
+}
+
+// Where kopForthEvaluate returns to once the string has been interpreted.
+kfStatus W_Evd(kopForth* forth) {  // --
+    (void) forth;
+    return KF_SYSTEM_EVALUATED;
+}
+
+
+
 // Fill interpreter/compiler words into memory.
 void kfPopulateWordsIntComp(kopForth* forth, kfWordsNative* wn,
                            kfWordsVarAddrConst* wv, kfWordsStackMem* wm,
                            kfWordsString* ws, kfWordsIntComp* wi) {
     // TODO Null check.
 
-    wi->src = kopForthAddWord(forth, "SOURCE");           // ( -- a u )
-        WRD(wv->tib); WRD(wv->htb); WRD(wn->att);         // TIB #TIB @
-        WRD(wn->ext);
-    wi->rfl = kopForthAddWord(forth, "REFILL");           // ( -- f )
-        WRD(wv->tib); LIT(80); WRD(wn->acc);              // TIB 80 ACCEPT
-        WRD(wv->htb); WRD(wn->exc);                       // #TIB !
-        LIT(0); WRD(wv->gin); WRD(wn->exc);               // 0 >IN !
-        WRD(ws->spa); WRD(wv->tru);                       // SPACE TRUE
-        WRD(wn->ext);
-    wi->exe = kopForthAddWord(forth, "EXECUTE");          // ( xt -- )
-        LITADDR(c4, wn->lit, 0);                          // <addr> ! <xt>
-        WRD(wn->exc);
-        WRDADDR(c5, (kfWord*) 0);
-        WRD(wn->ext);
-        *c4 = (isize) c5;
-    wi->cpl = kopForthAddWord(forth, "COMPILE,");         // ( xt -- )
-        WRD(wm->com);                                     // ,
-        WRD(wn->ext);
+    // Superinstructions
+    wi->lad = kopForthAddPrimWord(forth, "(LIT+)",        W_Lad, false, KF_PRIM_LAD);  // ( n1 -- n2 )
+    wi->dzb = kopForthAddPrimWord(forth, "(DUP-0BRANCH)", W_Dzb, false, KF_PRIM_DZB);  // ( n -- n )
+    wi->ovo = kopForthAddPrimWord(forth, "(OVER-OVER)",   W_Ovo, false, KF_PRIM_TDU);  // ( n1 n2 -- n1 n2 n1 n2 )
+    wi->rro = kopForthAddPrimWord(forth, "(R>-R>)",       W_Rro, false, KF_PRIM_RRO);  // ( -- n1 n2 )
+    wi->nip = kopForthAddPrimWord(forth, "(SWAP-DROP)",   W_Nip, false, KF_PRIM_NIP);  // ( n1 n2 -- n2 )
+    forth->debug_words.lad = wi->lad;
+    forth->debug_words.dzb = wi->dzb;
+    forth->fuse_rules[0] = (kfFuseRule) {wn->lit, 1, wm->add, wi->lad};  // (LIT) n +   -> (LIT+) n
+    forth->fuse_rules[1] = (kfFuseRule) {wn->dup, 0, wn->zbr, wi->dzb};  // DUP 0BRANCH -> (DUP-0BRANCH)
+    forth->fuse_rules[2] = (kfFuseRule) {wm->ovr, 0, wm->ovr, wi->ovo};  // OVER OVER   -> (OVER-OVER)
+    forth->fuse_rules[3] = (kfFuseRule) {wn->rpo, 0, wn->rpo, wi->rro};  // R> R>       -> (R>-R>)
+    forth->fuse_rules[4] = (kfFuseRule) {wn->swp, 0, wn->drp, wi->nip};  // SWAP DROP   -> (SWAP-DROP)
+
+    // Words that get folded when their inputs are literals. The words from
+    // kfWordsStackMem.h are only folded when they're native, otherwise they get
+    // inlined and the native words they're made of are folded instead.
+    kfFoldRule* fold = forth->fold_rules;
+    *fold++ = (kfFoldRule) {wn->sub, 2, 1};  // -
+    *fold++ = (kfFoldRule) {wn->mul, 2, 1};  // *
+    *fold++ = (kfFoldRule) {wn->equ, 2, 1};  // =
+    *fold++ = (kfFoldRule) {wn->lss, 2, 1};  // <
+    *fold++ = (kfFoldRule) {wn->nan, 2, 1};  // NAND
+    *fold++ = (kfFoldRule) {wn->drp, 1, 0};  // DROP
+    *fold++ = (kfFoldRule) {wn->dup, 1, 2};  // DUP
+    *fold++ = (kfFoldRule) {wn->swp, 2, 2};  // SWAP
+    *fold++ = (kfFoldRule) {wm->ovr, 2, 3};  // OVER
+    *fold++ = (kfFoldRule) {wm->rot, 3, 3};  // ROT
+    *fold++ = (kfFoldRule) {wm->tdr, 2, 0};  // 2DROP
+    *fold++ = (kfFoldRule) {wm->tdu, 2, 4};  // 2DUP
+    *fold++ = (kfFoldRule) {wm->add, 2, 1};  // +
+    *fold++ = (kfFoldRule) {wm->inv, 1, 1};  // INVERT
+    *fold++ = (kfFoldRule) {wm->orr, 2, 1};  // OR
+    *fold++ = (kfFoldRule) {wm->and, 2, 1};  // AND
+    *fold++ = (kfFoldRule) {wm->xor, 2, 1};  // XOR
+    *fold++ = (kfFoldRule) {wm->lsh, 2, 1};  // LSHIFT
+    *fold++ = (kfFoldRule) {wm->rsh, 2, 1};  // RSHIFT
+    *fold++ = (kfFoldRule) {wm->zeq, 1, 1};  // 0=
+    *fold++ = (kfFoldRule) {wm->neq, 2, 1};  // <>
+    *fold++ = (kfFoldRule) {wm->leq, 2, 1};  // <=
+    *fold++ = (kfFoldRule) {wm->gtr, 2, 1};  // >
+    *fold++ = (kfFoldRule) {wm->geq, 2, 1};  // >=
+    *fold++ = (kfFoldRule) {wm->cls, 1, 1};  // CELLS
+    *fold++ = (kfFoldRule) {wi->ovo, 2, 4};  // (OVER-OVER)
+    *fold++ = (kfFoldRule) {wi->nip, 2, 1};  // (SWAP-DROP)
+    *fold++ = (kfFoldRule) {wn->mss, 4, 2};  // M*/
+    *fold++ = (kfFoldRule) {wn->dpl, 4, 2};  // D+
+    *fold++ = (kfFoldRule) {wn->ums, 2, 2};  // UM*
+    *fold++ = (kfFoldRule) {wn->mst, 2, 2};  // M*
+    *fold++ = (kfFoldRule) {wn->umm, 3, 2};  // UM/MOD
+    *fold++ = (kfFoldRule) {wn->smr, 3, 2};  // SM/REM
+    *fold++ = (kfFoldRule) {wn->fmm, 3, 2};  // FM/MOD
+    *fold++ = (kfFoldRule) {wn->div, 2, 1};  // /
+    *fold++ = (kfFoldRule) {wn->mod, 2, 1};  // MOD
+    *fold++ = (kfFoldRule) {wn->dmo, 2, 2};  // /MOD
+    *fold++ = (kfFoldRule) {wn->sts, 3, 1};  // */
+    *fold++ = (kfFoldRule) {wn->ssm, 3, 2};  // */MOD
+    *fold++ = (kfFoldRule) {wn->dmi, 4, 2};  // D-
+    *fold++ = (kfFoldRule) {wn->dng, 2, 2};  // DNEGATE
+    *fold++ = (kfFoldRule) {wn->dls, 4, 1};  // D<
+    *fold++ = (kfFoldRule) {wn->deq, 4, 1};  // D=
+    *fold++ = (kfFoldRule) {wn->dab, 2, 2};  // DABS
+    *fold++ = (kfFoldRule) {wn->dtt, 2, 2};  // D2*
+    wi->frs = kopForthAddNativeWord(forth, "(FUSE-RESET)", W_Frs, false);  // ( -- )
+    wi->tex = kopForthAddNativeWord(forth, "(TAIL-EXIT)",  W_Tex, false);  // ( -- )
+    wi->inl = kopForthAddNativeWord(forth, "INLINE",       W_Inl, true );  // ( -- )
+    wi->fsd = kopForthAddNativeWord(forth, ".FUSED",       W_Fsd, false);  // ( "name" -- )
+
+    wi->src = kopForthAddNativeWord(forth, "SOURCE",    W_Src, false);  // ( -- a u )
+    wi->sid = kopForthAddNativeWord(forth, "SOURCE-ID", W_Sid, false);  // ( -- n )
+    wi->prs = kopForthAddNativeWord(forth, "PARSE",       W_Prs, false);  // ( char -- a u )
+    wi->pnm = kopForthAddNativeWord(forth, "PARSE-NAME",  W_Pnm, false);  // ( -- a u )
+    wi->fnm = kopForthAddNativeWord(forth, "FIND-NAME",   W_Fnm, false);  // ( a u -- nt | 0 )
+    wi->pfn = kopForthAddNativeWord(forth, "(FIND-NAME)", W_Pfn, false);  // ( a u -- a u 0 | xt 1 | xt -1 )
+    wi->cmt = kopForthAddNativeWord(forth, "(",           W_Cmt, true );  // ( "ccc<paren>" -- )
+    wi->bsl = kopForthAddNativeWord(forth, "\\",          W_Bsl, true );  // ( "ccc<eol>" -- )
+    wi->rfl = kopForthAddNativeWord(forth, "REFILL",   W_Rfl, false);  // ( -- f )
+    wi->exe = kopForthAddPrimWord(forth, "EXECUTE", W_Exe, false, KF_PRIM_THREAD);  // ( xt -- )
+    wi->cpl = kopForthAddNativeWord(forth, "COMPILE,", W_Cpl, false);  // ( xt -- )
     wi->rev = kopForthAddWord(forth, "REVEAL");           // ( -- )
         WRD(wv->ppt); WRD(wn->att);                       // PP @
         WRD(wv->lpt); WRD(wn->exc);                       // LP !
@@ -70,16 +713,17 @@ void kfPopulateWordsIntComp(kopForth* forth, kfWordsNative* wn,
         wi->obr->flags.bit_flags.is_immediate = 1;
     wi->cbr = kopForthAddWord(forth, "]");                // ( -- )
         WRD(wv->tru); WRD(wv->sta); WRD(wn->exc);         // TRUE STATE !
+        WRD(wi->frs);                                     // (FUSE-RESET)
         WRD(wn->ext);
     wi->abt = kopForthAddWord(forth, "ABORT");            // ( * -- )
         // TODO undo any words being constructed
         WRD(wn->crs);                                     // (CLR-RET-STACK)
         WRD(wn->cds);                                     // (CLR-DAT-STACK)
         WRDADDR(abt00, wn->ext);                          // QUIT
-    wi->enf = kopForthAddWord(forth, "(ERR-NOT-FOUND)");  // ( a -- )
+    wi->enf = kopForthAddWord(forth, "(ERR-NOT-FOUND)");  // ( a u -- )
         WRD(ws->crr);                                     // CR
         PRSTR("ERROR: '");                                // ." ERROR: "
-        WRD(ws->cnt); WRD(wn->typ);                       // COUNT TYPE
+        WRD(wn->typ);                                     // TYPE
         PRSTR("' word not found");                        // ."  word not found"
         WRD(ws->crr); WRD(wi->abt);                       // CR ABORT
         WRD(wn->ext);
@@ -87,7 +731,7 @@ void kfPopulateWordsIntComp(kopForth* forth, kfWordsNative* wn,
         WRD(wn->cre); WRD(wi->cbr);                       // CREATE POSTPONE ]
         WRD(wn->ext);
     wi->sem = kopForthAddWord(forth, ";");                // ( -- )
-        LIT(wn->ext); WRD(wi->cpl);                       // ['] EXIT COMPILE,
+        WRD(wi->tex);                                     // (TAIL-EXIT)
         WRD(wi->rev); WRD(wi->obr);                       // REVEAL POSTPONE [
         WRD(wn->ext);
         wi->sem->flags.bit_flags.is_immediate = 1;
@@ -95,50 +739,49 @@ void kfPopulateWordsIntComp(kopForth* forth, kfWordsNative* wn,
     wi->inp = kopForthAddWord(forth, "INTERPRET"); {             // ( -- )
         LIT(0); WRD(wv->gin); WRD(wn->exc);                      // 0 >IN !                                   (  )
                                                                  // BEGIN                                     (  )
-        WRDADDR(b00, ws->bla); WRD(wn->wrd);                     //     BL WORD                               ( c-addr )
-        WRD(wn->dup); WRD(ws->cnt); WRD(wn->swp); WRD(wn->drp);  //     DUP COUNT SWAP DROP                   ( c-addr u )
-        LITADDR(b01, wn->zbr, 0);                                // WHILE                                     ( c-addr )
-        WRD(wn->fnd);                                            //     FIND                                  ( c-addr 0 | xt 1 | xt -1 )
-        WRD(wv->sta); WRD(wn->att); LITADDR(b02, wn->zbr, 0);    //     STATE @ IF      \ Compiling           ( c-addr 0 | xt 1 | xt -1 )
+        WRDADDR(b00, wi->pnm); WRD(wn->dup);                     //     PARSE-NAME DUP                        ( c-addr u u )
+        LITADDR(b01, wn->zbr, 0);                                // WHILE                                     ( c-addr u )
+        WRD(wi->pfn);                                            //     (FIND-NAME)                           ( c-addr u 0 | xt 1 | xt -1 )
+        WRD(wv->sta); WRD(wn->att); LITADDR(b02, wn->zbr, 0);    //     STATE @ IF      \ Compiling           ( c-addr u 0 | xt 1 | xt -1 )
         WRD(wn->dup); LITADDR(b03, wn->zbr, 0);                  //         DUP IF      \ Word                ( xt 1 | xt -1 )
         LIT(1); WRD(wn->equ); LITADDR(b04, wn->zbr, 0);          //             1 = IF  \ Immediate           ( xt )
-        WRD(wi->exe);                                            //                 EXECUTE                   ( ? )
+        WRD(wi->exe); WRD(wi->frs);                              //                 EXECUTE (FUSE-RESET)      ( ? )
         LITADDR(b05, wn->bra, 0);                                //             ELSE                          ( xt )
         WRDADDR(b06, wi->cpl);                                   //                 COMPILE,                  (  )
                                                                  //             THEN                          ( ? )
-        WRDADDR(b07, wn->bra); RAWADDR(b08, 0);                  //         ELSE        \ Unknown             ( c-addr 0 )
-        WRDADDR(b09, wn->drp); WRD(wn->dup); WRD(ws->cnt);       //             DROP DUP COUNT                ( c-addr c-addr2 u )
-        WRD(ws->snu);                                            //             S>NUMBER?                     ( c-addr n 0 0 | c-addr d -1 0 | c-addr c-addr3 u2 )
-        LITADDR(b10, wn->zbr, 0);                                //             IF      \ Error               ( c-addr c-addr3 )
+        WRDADDR(b07, wn->bra); RAWADDR(b08, 0);                  //         ELSE        \ Unknown             ( c-addr u 0 )
+        WRDADDR(b09, wn->drp); WRD(wm->tdu);                     //             DROP 2DUP                     ( c-addr u c-addr u )
+        WRD(ws->snu);                                            //             S>NUMBER?                     ( c-addr u n 0 0 | c-addr u d -1 0 | c-addr u c-addr2 u2 )
+        LITADDR(b10, wn->zbr, 0);                                //             IF      \ Error               ( c-addr u c-addr2 )
         WRD(wn->drp); WRD(wi->enf);                              //                 DROP (ERR-NOT-FOUND)      (  )
-        LITADDR(b11, wn->bra, 0);                                //             ELSE    \ Number              ( c-addr n 0 | c-addr d -1 )
-        WRDADDR(b12, wn->zbr); RAWADDR(b13, 0);                  //                 IF  \ Double              ( c-addr d )
-        WRD(wn->swp);                                            //                     SWAP                  ( c-addr n n )
-        LIT(wn->lit); WRD(wi->cpl); WRD(wm->com);                //                     ['] (LIT) COMPILE, ,  ( c-addr n )
-        WRDADDR(b14, wn->lit); RAW(wn->lit);                     //                 THEN ['] (LIT)            ( c-addr n xt )
-        WRD(wi->cpl); WRD(wm->com);                              //                 COMPILE, ,                ( c-addr )
-        WRD(wn->drp);                                            //                 DROP                      (  )
+        LITADDR(b11, wn->bra, 0);                                //             ELSE    \ Number              ( c-addr u n 0 | c-addr u d -1 )
+        WRDADDR(b12, wn->zbr); RAWADDR(b13, 0);                  //                 IF  \ Double              ( c-addr u d )
+        WRD(wn->swp);                                            //                     SWAP                  ( c-addr u n n )
+        LIT(wn->lit); WRD(wi->cpl); WRD(wm->com);                //                     ['] (LIT) COMPILE, ,  ( c-addr u n )
+        WRDADDR(b14, wn->lit); RAW(wn->lit);                     //                 THEN ['] (LIT)            ( c-addr u n xt )
+        WRD(wi->cpl); WRD(wm->com);                              //                 COMPILE, ,                ( c-addr u )
+        WRD(wm->tdr);                                            //                 2DROP                     (  )
                                                                  //             THEN                          (  )
                                                                  //         THEN                              ( ? )
-        WRDADDR(b15, wn->bra); RAWADDR(b16, 0);                  //     ELSE            \ Interpreting        ( c-addr 0 | xt 1 | xt -1 )
+        WRDADDR(b15, wn->bra); RAWADDR(b16, 0);                  //     ELSE            \ Interpreting        ( c-addr u 0 | xt 1 | xt -1 )
         WRDADDR(b17, wn->zbr); RAWADDR(b18, 0);                  //         IF          \ Word                ( xt )
                                                                  //             // TODO check if not compile only
         WRD(wi->exe);                                            //             EXECUTE                       ( ? )
-        LITADDR(b19, wn->bra, 0);                                //         ELSE        \ Unknown             ( c-addr )
-        WRDADDR(b20, wn->dup); WRD(ws->cnt); WRD(ws->snu);       //             DUP COUNT S>NUMBER?           ( c-addr n 0 0 | c-addr d -1 0 | c-addr c-addr2 u )
-        LITADDR(b21, wn->zbr, 0);                                //             IF      \ Error               ( c-addr c-addr2 )
+        LITADDR(b19, wn->bra, 0);                                //         ELSE        \ Unknown             ( c-addr u )
+        WRDADDR(b20, wm->tdu); WRD(ws->snu);                     //             2DUP S>NUMBER?                ( c-addr u n 0 0 | c-addr u d -1 0 | c-addr u c-addr2 u2 )
+        LITADDR(b21, wn->zbr, 0);                                //             IF      \ Error               ( c-addr u c-addr2 )
         WRD(wn->drp); WRD(wi->enf);                              //                 DROP (ERR-NOT-FOUND)      (  )
-                                                                 //             THEN    \ Number              ( c-addr n 0 | c-addr d -1 )
-        WRDADDR(b22, wn->zbr); RAWADDR(b23, 0);                  //             IF      \ Double              ( c-addr d )
-        WRD(wm->rot);                                            //                 ROT                       ( d c-addr )
-        LITADDR(b24, wn->bra, 0);                                //             ELSE    \ Single              ( c-addr n )
-        WRDADDR(b25, wn->swp);                                   //                 SWAP                      ( n c-addr )
+                                                                 //             THEN    \ Number              ( c-addr u n 0 | c-addr u d -1 )
+        WRDADDR(b22, wn->zbr); RAWADDR(b23, 0);                  //             IF      \ Double              ( c-addr u d )
+        WRD(wm->rot); WRD(wn->drp); WRD(wm->rot);                //                 ROT DROP ROT              ( d c-addr )
+        LITADDR(b24, wn->bra, 0);                                //             ELSE    \ Single              ( c-addr u n )
+        WRDADDR(b25, wn->swp); WRD(wn->drp); WRD(wn->swp);       //                 SWAP DROP SWAP            ( n c-addr )
                                                                  //             THEN                          ( d c-addr | n c-addr )
         WRDADDR(b26, wn->drp);                                   //             DROP                          ( n | d )
                                                                  //         THEN                              ( ? | n | d )
                                                                  //     THEN                                  ( ? | n | d )
-        WRDADDR(b27, wn->bra); RAWADDR(b28, 0);                  // REPEAT                                    ( c-addr )
-        WRDADDR(b29, wn->drp);                                   // DROP                                      (  )
+        WRDADDR(b27, wn->bra); RAWADDR(b28, 0);                  // REPEAT                                    ( c-addr u )
+        WRDADDR(b29, wm->tdr);                                   // 2DROP                                     (  )
         WRD(wn->ext);
         *b28 = (isize) b00;
         *b01 = (isize) b29;
@@ -156,8 +799,52 @@ void kfPopulateWordsIntComp(kopForth* forth, kfWordsNative* wn,
         *b21 = (isize) b22;
         *b23 = (isize) b25;
         *b24 = (isize) b26; }
+    wi->ifl = kopForthAddNativeWord(forth, "(INCLUDE-FILE)",  W_Ifl, false);  // ( fileid -- )
+    wi->ind = kopForthAddNativeWord(forth, "(INCLUDED)",      W_Ind, false);  // ( a u -- )
+    wi->sen = kopForthAddNativeWord(forth, "(SOURCE-END)",    W_Sen, false);  // ( -- )
+    wi->idq = kopForthAddNativeWord(forth, "(INCLUDED?)",     W_Idq, false);  // ( a u -- a u f )
+    wi->srs = kopForthAddNativeWord(forth, "(SOURCE-RESET)",  W_Srs, false);  // ( -- )
+    wi->evs = kopForthAddNativeWord(forth, "(EVALUATE)",      W_Evs, false);  // ( a u -- )
+    wi->evd = kopForthAddNativeWord(forth, "(EVALUATE-DONE)", W_Evd, false);  // ( -- )
+    wi->ilp = kopForthAddWord(forth, "(INCLUDE-LOOP)"); {        // ( -- )
+                                                                 // BEGIN
+        WRDADDR(b00, wi->rfl);                                   //     REFILL  ( f )
+        LITADDR(b01, wn->zbr, 0);                                // WHILE
+        WRD(wi->inp);                                            //     INTERPRET
+        LITADDR(b02, wn->bra, 0);                                // REPEAT
+        WRDADDR(b03, wi->sen);                                   // (SOURCE-END)
+        WRD(wn->ext);
+        *b02 = (isize) b00;
+        *b01 = (isize) b03; }
+    wi->inf = kopForthAddWord(forth, "INCLUDE-FILE");     // ( fileid -- )
+        WRD(wi->ifl); WRD(wi->ilp);                       // (INCLUDE-FILE) (INCLUDE-LOOP)
+        WRD(wn->ext);
+    wi->icd = kopForthAddWord(forth, "INCLUDED");         // ( a u -- )
+        WRD(wi->ind); WRD(wi->ilp);                       // (INCLUDED) (INCLUDE-LOOP)
+        WRD(wn->ext);
+    wi->req = kopForthAddWord(forth, "REQUIRED"); {       // ( a u -- )
+        WRD(wi->idq);                                     // (INCLUDED?)
+        LITADDR(b00, wn->zbr, 0);                         // IF
+        WRD(wm->tdr); WRD(wn->ext);                       //     2DROP EXIT
+                                                          // THEN
+        WRDADDR(b01, wi->icd);                            // INCLUDED
+        WRD(wn->ext);
+        *b00 = (isize) b01; }
+    wi->icl = kopForthAddWord(forth, "INCLUDE");          // ( "name" -- )
+        WRD(wi->pnm);                                     // PARSE-NAME
+        WRD(wi->icd);                                     // INCLUDED
+        WRD(wn->ext);
+    wi->rqr = kopForthAddWord(forth, "REQUIRE");          // ( "name" -- )
+        WRD(wi->pnm);                                     // PARSE-NAME
+        WRD(wi->req);                                     // REQUIRED
+        WRD(wn->ext);
+    wi->evl = kopForthAddWord(forth, "EVALUATE");         // ( a u -- )
+        WRD(wi->evs); WRD(wi->inp);                       // (EVALUATE) INTERPRET
+        WRD(wi->sen);                                     // (SOURCE-END)
+        WRD(wn->ext);
     wi->qut = kopForthAddWord(forth, "QUIT"); {                  // ( -- )
         WRD(wn->crs);                                            // (CLR-RET-STACK)
+        WRD(wi->srs);                                            // (SOURCE-RESET)
         WRD(wi->obr);                                            // POSTPONE [
                                                                  // BEGIN
         WRDADDR(b00, wi->rfl);                                   //     REFILL  ( f )
@@ -166,12 +853,12 @@ void kfPopulateWordsIntComp(kopForth* forth, kfWordsNative* wn,
         PRSTR(" ok");                                            //     ."  ok"
         WRD(ws->crr);                                            //     CR
         LITADDR(b02, wn->bra, 0);                                // REPEAT
-        WRDADDR(b03, wn->ext);
+        WRDADDR(b03, wn->bye);                                   // BYE  \ End of input
+        WRD(wn->ext);
         *b02 = (isize) b00;
         *b01 = (isize) b03;
         *abt00 = wi->qut; }
 
-    //wi->evl = kopForthAddWord(forth, "EVALUATE");  // ( -- )
     //wi->pst = kopForthAddWord(forth, "POSTPONE");  // ( -- )
 }
 
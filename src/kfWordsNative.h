@@ -2,12 +2,14 @@
 #define KF_WORDS_NATIVE_H
 
 /*
- * kfWordsNative.h (last modified 2025-06-17)
+ * kfWordsNative.h (last modified 2026-10-18)
  * This contains the native word definitions for the kopForth system.
  */
 
 #include "kfBios.h"
+#include "kfDict.h"
 #include "kfMath.h"
+#include "kfScan.h"
 #include "kfStack.h"
 #include "kfStatus.h"
 #include "kfType.h"
@@ -19,6 +21,7 @@ typedef struct kfWordsNative kfWordsNative;
 struct kfWordsNative {
     kfWord* ext;
     kfWord* lit;
+    kfWord* usr;
     kfWord* sub;
     kfWord* mul;
     kfWord* dot;
@@ -44,6 +47,22 @@ struct kfWordsNative {
     kfWord* fnd;
     kfWord* mss;
     kfWord* dpl;
+    kfWord* ums;
+    kfWord* mst;
+    kfWord* umm;
+    kfWord* smr;
+    kfWord* fmm;
+    kfWord* div;
+    kfWord* mod;
+    kfWord* dmo;
+    kfWord* sts;
+    kfWord* ssm;
+    kfWord* dmi;
+    kfWord* dng;
+    kfWord* dls;
+    kfWord* deq;
+    kfWord* dab;
+    kfWord* dtt;
     kfWord* equ;
     kfWord* lss;
     kfWord* nan;
@@ -52,6 +71,7 @@ struct kfWordsNative {
     kfWord* dqu;
     kfWord* bye;
     kfWord* dos;
+    kfWord* dpt;
     kfWord* crs;
     kfWord* cds;
 };
@@ -75,6 +95,17 @@ kfStatus W_Lit(kopForth* forth) {  // -- n
     return KF_STATUS_OK;
 }
 
+// Pushes the address of a field of the kopForth struct, like (LIT) but with an
+// offset from the struct.
+kfStatus W_Usr(kopForth* forth) {  // -- a
+    isize* offset;
+    KF_RETN_POP(offset);
+    KF_DATA_PUSH((uint8_t*) forth + *offset);
+    offset++;
+    KF_RETN_PUSH(offset);
+    return KF_STATUS_OK;
+}
+
 kfStatus W_Sub(kopForth* forth) {  // n1 n2 -- n3
     isize a, b;
     KF_DATA_POP(b);
@@ -91,10 +122,29 @@ kfStatus W_Mul(kopForth* forth) {  // n1 n2 -- n3
     return KF_STATUS_OK;
 }
 
+// Prints in BASE, or in decimal if BASE isn't a usable radix.
 kfStatus W_Dot(kopForth* forth) {  // n --
     isize a;
     KF_DATA_POP(a);
-    kfBiosPrintIsize(a);
+    isize base = forth->base;
+    if (base == 10 || base < 2 || base > 36) {
+        kfBiosPrintIsize(a);
+    } else {
+        // The digits get filled in from the end, so it's written all at once.
+        usize u = a < 0 ? 0 - (usize) a : (usize) a;
+        char digits[sizeof(isize) * 8 + 2];
+        usize n = sizeof(digits);
+        digits[--n] = ' ';
+        do {
+            usize digit = u % base;
+            digits[--n] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+            u /= base;
+        } while (u != 0);
+        if (a < 0)
+            digits[--n] = '-';
+        kfBiosWriteStrLen(digits + n, sizeof(digits) - n);
+        return KF_STATUS_OK;
+    }
     kfBiosWriteChar(' ');
     return KF_STATUS_OK;
 }
@@ -204,18 +254,74 @@ kfStatus W_Emt(kopForth* forth) {  // n --
     return KF_STATUS_OK;
 }
 
+// Points `source` at the copy in TIB if it's part of the `len` bytes that were
+// copied there from `from`.
+void kfKeepMove(kopForth* forth, uint8_t** source, usize source_len,
+                uint8_t* from, usize len) {
+    if (*source >= from && *source + source_len <= from + len)
+        *source = forth->tib + (*source - from);
+}
+
+// REFILL parses batch lines right where the bios buffered them, and reading
+// more input can move them, so this moves the line being parsed into TIB
+// before KEY or ACCEPT read from batch input. When they're read inside an
+// included file or an EVALUATE, that line is the bottom input source, still
+// waiting to be picked up again, and strings EVALUATE was given out of it are
+// moved along with it.
+void kfKeepSource(kopForth* forth) {
+    if (!kfBiosIsBatch())
+        return;
+    bool nested = forth->source_depth > 0;
+    uint8_t** source = nested ? &forth->sources[0].source : &forth->source;
+    usize* source_len = nested ? &forth->sources[0].source_len : &forth->source_len;
+    usize* in_offset = nested ? &forth->sources[0].in_offset : &forth->in_offset;
+    if (*source == forth->tib)
+        return;
+    // Keep >IN where it is if the whole line fits, or else just keep the rest.
+    uint8_t* keep = *source;
+    usize len = *source_len;
+    if (len > KF_TIB_SIZE) {
+        keep += *in_offset;
+        len -= *in_offset;
+        *in_offset = 0;
+        if (len > KF_TIB_SIZE)
+            len = KF_TIB_SIZE;
+    }
+    memcpy(forth->tib, keep, len);
+    forth->tib_len = len;
+    *source = forth->tib;
+    *source_len = len;
+    if (nested) {
+        for (usize i = 1; i < forth->source_depth; i++)
+            kfKeepMove(forth, &forth->sources[i].source, forth->sources[i].source_len, keep, len);
+        kfKeepMove(forth, &forth->source, forth->source_len, keep, len);
+    }
+}
+
 kfStatus W_Key(kopForth* forth) {  // -- n
+    kfKeepSource(forth);
     KF_DATA_PUSH(kfBiosReadChar());
     return KF_STATUS_OK;
 }
 
-kfStatus W_Acc(kopForth* forth) {  // addr u1 -- u2
-    uint8_t* addr;
-    isize u1, u2 = 0;
-    KF_DATA_POP(u1);
-    KF_DATA_POP(addr);
+// Reads a line of up to `u1` characters into `addr`, and returns its length or
+// -1 at the end of input. Terminal input is echoed and can be edited with
+// backspace, batch input is copied over a line at a time.
+isize kfAccept(uint8_t* addr, isize u1) {
+    isize u2 = 0;
+    if (kfBiosIsBatch()) {
+        char* line;
+        u2 = kfBiosReadLine(&line);
+        if (u2 > u1)
+            u2 = u1 < 0 ? 0 : u1;
+        if (u2 > 0)
+            memcpy(addr, line, u2);
+        return u2;
+    }
     while (true) {
         isize c = kfBiosReadChar();
+        if (c == -1)
+            return u2 > 0 ? u2 : -1;
         if (c == KF_CR)
             break;
         if (c == '\b') {
@@ -234,39 +340,65 @@ kfStatus W_Acc(kopForth* forth) {  // addr u1 -- u2
         addr[u2] = c;
         u2++;
     }
-    KF_DATA_PUSH(u2);
+    return u2;
+}
+
+kfStatus W_Acc(kopForth* forth) {  // addr u1 -- u2
+    uint8_t* addr;
+    isize u1, u2;
+    KF_DATA_POP(u1);
+    KF_DATA_POP(addr);
+    kfKeepSource(forth);
+    u2 = kfAccept(addr, u1);
+    KF_DATA_PUSH(u2 < 0 ? 0 : u2);
     return KF_STATUS_OK;
 }
 
+// Where the rest of the input source starts, which is its end once >IN has
+// been set past it.
+uint8_t* kfParseStart(kopForth* forth) {
+    usize offset = forth->in_offset;
+    if (offset > forth->source_len)
+        offset = forth->source_len;
+    return forth->source + offset;
+}
+
+// Parses up to the next `delim` in the input source, and moves >IN past it.
+// Returns where the text starts in the source, and its length in `len`.
+uint8_t* kfParse(kopForth* forth, isize delim, usize* len) {
+    uint8_t* end = forth->source + forth->source_len;
+    uint8_t* start = kfParseStart(forth);
+    uint8_t* stop = kfScanUntil(start, end, delim);
+    *len = stop - start;
+    forth->in_offset = (stop < end ? stop + 1 : stop) - forth->source;
+    return start;
+}
+
+// Parses the next whitespace delimited name in the input source, the same as
+// kfParse but skipping any whitespace before it. `len` is 0 at the end of the
+// source.
+uint8_t* kfParseName(kopForth* forth, usize* len) {
+    uint8_t* end = forth->source + forth->source_len;
+    forth->in_offset = kfScanSkip(kfParseStart(forth), end, ' ') - forth->source;
+    return kfParse(forth, ' ', len);
+}
+
 kfStatus W_Wrd(kopForth* forth) {  // char -- addr
     isize c;
     KF_DATA_POP(c);
-    // write 0 (len) to HERE
-    *forth->here = 0;
-    // put HERE on the stack
-    KF_DATA_PUSH(forth->here);
-    if (forth->in_offset >= forth->tib_len)
-        return KF_STATUS_OK;
-    // skip leading `char` in input stream
-    while (forth->tib[forth->in_offset] == c) {
-        forth->in_offset++;
-        if (forth->in_offset >= forth->tib_len)
-            return KF_STATUS_OK;
-    }
-    // start copying !char characters to HERE+1
-    uint8_t* h = forth->here + 1;
-    usize ct = 0;
-    while (forth->tib[forth->in_offset] != c) {
-        *h = forth->tib[forth->in_offset];
-        h++;
-        ct++;
-        forth->in_offset++;
-        if (forth->in_offset >= forth->tib_len)
-            break;
-    }
-    // update the value at HERE (1 byte)
+    uint8_t* end = forth->source + forth->source_len;
+    // skip leading `char` in input stream, and find the end of the word
+    uint8_t* start = kfScanSkip(kfParseStart(forth), end, c);
+    uint8_t* stop = kfScanUntil(start, end, c);
+    // copy it to HERE+1, as much as the count can hold, with its length at HERE
+    usize ct = stop - start;
+    if (ct > UINT8_MAX)
+        ct = UINT8_MAX;
+    memcpy(forth->here + 1, start, ct);
     *forth->here = ct;
     // update the >IN to show what's been consumed
+    forth->in_offset = stop - forth->source;
+    KF_DATA_PUSH(forth->here);
     return KF_STATUS_OK;
 }
 
@@ -304,75 +436,60 @@ kfStatus W_Cmp(kopForth* forth) {  // a1 u1 a2 u2 -- n
     KF_DATA_POP(a2);
     KF_DATA_POP(u1);
     KF_DATA_POP(a1);
-    usize m = u1 > u2 ? u1 : u2;
-    for (usize i = 0; i < m; i++) {
-        if (a1[i] < a2[i]) {
-            KF_DATA_PUSH(-1);
-            return KF_STATUS_OK;
-        }
-        if (a1[i] > a2[i]) {
-            KF_DATA_PUSH(1);
-            return KF_STATUS_OK;
-        }
-    }
-    if (u1 < m)
-        KF_DATA_PUSH(-1);
-    else if (u2 < m)
-        KF_DATA_PUSH(1);
-    else
-        KF_DATA_PUSH(0);
+    usize n = u1 < u2 ? u1 : u2;
+    usize i = kfScanMismatch(a1, a2, n);
+    isize result = 0;
+    if (i < n)
+        result = a1[i] < a2[i] ? -1 : 1;
+    else if (u1 != u2)
+        result = u1 < u2 ? -1 : 1;
+    KF_DATA_PUSH(result);
     return KF_STATUS_OK;
 }
 
+// FIND for a string of any length. A name longer than a count can hold can't
+// be in the dictionary. The name token of a word is its xt.
+kfWord* kfFindName(kopForth* forth, uint8_t* addr, usize len) {
+    if (len > UINT8_MAX)
+        return NULL;
+    return kfDictFind(forth, addr, len);
+}
+
 kfStatus W_Fnd(kopForth* forth) {  // c-addr -- c-addr 0 | xt 1 | xt -1
     uint8_t* f_str;
     KF_DATA_POP(f_str);
-    uint8_t str_ct = *f_str;
-    uint8_t* str_head = f_str + 1;
-    kfWord* word = (kfWord*) forth->latest;
-    while (word != NULL && str_ct != 0) {
-        if (word->name_len == str_ct) {
-            bool match = true;
-            for (uint8_t i = 0; i < str_ct; i++) {
-                uint8_t c1 = str_head[i];
-                uint8_t c2 = word->name[i];
-                if (c1 >= 'A' && c1 <= 'Z') {
-                    c1 += 32;
-                }
-                if (c2 >= 'A' && c2 <= 'Z') {
-                    c2 += 32;
-                }
-                if (c1 != c2) {
-                    match = false;
-                    break;
-                }
-            }
-            if (match) {
-                KF_DATA_PUSH(word);
-                KF_DATA_PUSH(word->flags.bit_flags.is_immediate ? 1 : -1);
-                return KF_STATUS_OK;
-            }
-        }
-        word = word->link;
+    kfWord* word = kfDictFind(forth, f_str + 1, *f_str);
+    if (word == NULL) {
+        KF_DATA_PUSH(f_str);
+        KF_DATA_PUSH(0);
+        return KF_STATUS_OK;
     }
-    KF_DATA_PUSH(f_str);
-    KF_DATA_PUSH(0);
+    KF_DATA_PUSH(word);
+    KF_DATA_PUSH(word->flags.bit_flags.is_immediate ? 1 : -1);
     return KF_STATUS_OK;
 }
 
+// The product is a triple cell so it can't overflow before the divide, and the
+// quotient is rounded toward zero.
 kfStatus W_Mss(kopForth* forth) {  // d1 n1 +n2 -- d2
-    TwoCell doub, mult;
-    isize div;
+    TwoCell doub;
+    isize mult, div;
     KF_DATA_POP(div);
-    if (div != 1) {
-        kfBiosWriteStr("M*/ +n2 != 1");
-        return KF_SYSTEM_NOT_IMP;
-    }
-    KF_DATA_POP(mult.low);
-    mult.high = mult.low < 0 ? -1 : 0;
+    if (div == 0)
+        return KF_MATH_DIV_ZERO;
+    KF_DATA_POP(mult);
     KF_DATA_POP(doub.high);
     KF_DATA_POP(doub.low);
-    doub = ByteCellToTwoCell(ByteCellsMultiply(TwoCellToByteCell(doub), TwoCellToByteCell(mult)));
+    bool negative = (doub.high < 0) != (mult < 0);
+    if (doub.high < 0)
+        doub = TwoCellNegate(doub);
+    usize umult = mult < 0 ? 0 - (usize) mult : (usize) mult;
+    usize udiv = div < 0 ? 0 - (usize) div : (usize) div;
+    if (div < 0)
+        negative = !negative;
+    doub = TwoCellMulDiv(doub, umult, udiv);
+    if (negative)
+        doub = TwoCellNegate(doub);
     KF_DATA_PUSH(doub.low);
     KF_DATA_PUSH(doub.high);
     return KF_STATUS_OK;
@@ -384,12 +501,208 @@ kfStatus W_Dpl(kopForth* forth) {  // d1 d2 -- d3
     KF_DATA_POP(d2.low);
     KF_DATA_POP(d1.high);
     KF_DATA_POP(d1.low);
-    d1 = ByteCellToTwoCell(ByteCellsAdd(TwoCellToByteCell(d1), TwoCellToByteCell(d2)));
+    d1 = TwoCellAdd(d1, d2);
     KF_DATA_PUSH(d1.low);
     KF_DATA_PUSH(d1.high);
     return KF_STATUS_OK;
 }
 
+// Mixed and double cell math. Single cell division (/, MOD, /MOD, */ and
+// */MOD) is symmetric like SM/REM, so the quotient is rounded toward zero.
+// Quotients that don't fit in a cell are cut down to one.
+
+kfStatus W_Ums(kopForth* forth) {  // u1 u2 -- ud
+    usize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    TwoCell d = UsizeMultiply(a, b);
+    KF_DATA_PUSH(d.low);
+    KF_DATA_PUSH(d.high);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Mst(kopForth* forth) {  // n1 n2 -- d
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    TwoCell d = IsizeMultiply(a, b);
+    KF_DATA_PUSH(d.low);
+    KF_DATA_PUSH(d.high);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Umm(kopForth* forth) {  // ud u1 -- u2 u3
+    TwoCell d;
+    usize div, rem;
+    KF_DATA_POP(div);
+    if (div == 0)
+        return KF_MATH_DIV_ZERO;
+    KF_DATA_POP(d.high);
+    KF_DATA_POP(d.low);
+    d = TwoCellDivide(d, div, &rem);
+    KF_DATA_PUSH(rem);
+    KF_DATA_PUSH(d.low);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Smr(kopForth* forth) {  // d1 n1 -- n2 n3
+    TwoCell d;
+    isize div, rem;
+    KF_DATA_POP(div);
+    if (div == 0)
+        return KF_MATH_DIV_ZERO;
+    KF_DATA_POP(d.high);
+    KF_DATA_POP(d.low);
+    isize quot = TwoCellSymDivide(d, div, &rem);
+    KF_DATA_PUSH(rem);
+    KF_DATA_PUSH(quot);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Fmm(kopForth* forth) {  // d1 n1 -- n2 n3
+    TwoCell d;
+    isize div, rem;
+    KF_DATA_POP(div);
+    if (div == 0)
+        return KF_MATH_DIV_ZERO;
+    KF_DATA_POP(d.high);
+    KF_DATA_POP(d.low);
+    isize quot = TwoCellFloorDivide(d, div, &rem);
+    KF_DATA_PUSH(rem);
+    KF_DATA_PUSH(quot);
+    return KF_STATUS_OK;
+}
+
+// Pops the divisor and dividend of the single cell division words. The
+// dividend is sign extended to a double cell.
+kfStatus kfPopDivide(kopForth* forth, TwoCell* d, isize* div) {
+    KF_DATA_POP(*div);
+    if (*div == 0)
+        return KF_MATH_DIV_ZERO;
+    KF_DATA_POP(d->low);
+    d->high = d->low < 0 ? -1 : 0;
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Div(kopForth* forth) {  // n1 n2 -- n3
+    TwoCell d;
+    isize div, rem;
+    KF_RETURN_IF_ERROR(kfPopDivide(forth, &d, &div));
+    KF_DATA_PUSH(TwoCellSymDivide(d, div, &rem));
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Mod(kopForth* forth) {  // n1 n2 -- n3
+    TwoCell d;
+    isize div, rem;
+    KF_RETURN_IF_ERROR(kfPopDivide(forth, &d, &div));
+    TwoCellSymDivide(d, div, &rem);
+    KF_DATA_PUSH(rem);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Dmo(kopForth* forth) {  // n1 n2 -- n3 n4
+    TwoCell d;
+    isize div, rem;
+    KF_RETURN_IF_ERROR(kfPopDivide(forth, &d, &div));
+    isize quot = TwoCellSymDivide(d, div, &rem);
+    KF_DATA_PUSH(rem);
+    KF_DATA_PUSH(quot);
+    return KF_STATUS_OK;
+}
+
+// Pops n1 n2 n3 for */ and */MOD, leaving the double cell product of n1 and n2.
+kfStatus kfPopMulDivide(kopForth* forth, TwoCell* d, isize* div) {
+    isize a, b;
+    KF_DATA_POP(*div);
+    if (*div == 0)
+        return KF_MATH_DIV_ZERO;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    *d = IsizeMultiply(a, b);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Sts(kopForth* forth) {  // n1 n2 n3 -- n4
+    TwoCell d;
+    isize div, rem;
+    KF_RETURN_IF_ERROR(kfPopMulDivide(forth, &d, &div));
+    KF_DATA_PUSH(TwoCellSymDivide(d, div, &rem));
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Ssm(kopForth* forth) {  // n1 n2 n3 -- n4 n5
+    TwoCell d;
+    isize div, rem;
+    KF_RETURN_IF_ERROR(kfPopMulDivide(forth, &d, &div));
+    isize quot = TwoCellSymDivide(d, div, &rem);
+    KF_DATA_PUSH(rem);
+    KF_DATA_PUSH(quot);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Dmi(kopForth* forth) {  // d1 d2 -- d3
+    TwoCell d1, d2;
+    KF_DATA_POP(d2.high);
+    KF_DATA_POP(d2.low);
+    KF_DATA_POP(d1.high);
+    KF_DATA_POP(d1.low);
+    d1 = TwoCellAdd(d1, TwoCellNegate(d2));
+    KF_DATA_PUSH(d1.low);
+    KF_DATA_PUSH(d1.high);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Dng(kopForth* forth) {  // d1 -- d2
+    TwoCell d;
+    KF_DATA_POP(d.high);
+    KF_DATA_POP(d.low);
+    d = TwoCellNegate(d);
+    KF_DATA_PUSH(d.low);
+    KF_DATA_PUSH(d.high);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Dls(kopForth* forth) {  // d1 d2 -- flag
+    TwoCell d1, d2;
+    KF_DATA_POP(d2.high);
+    KF_DATA_POP(d2.low);
+    KF_DATA_POP(d1.high);
+    KF_DATA_POP(d1.low);
+    KF_DATA_PUSH(TwoCellLess(d1, d2) ? -1 : 0);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Deq(kopForth* forth) {  // d1 d2 -- flag
+    TwoCell d1, d2;
+    KF_DATA_POP(d2.high);
+    KF_DATA_POP(d2.low);
+    KF_DATA_POP(d1.high);
+    KF_DATA_POP(d1.low);
+    KF_DATA_PUSH(d1.low == d2.low && d1.high == d2.high ? -1 : 0);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Dab(kopForth* forth) {  // d -- ud
+    TwoCell d;
+    KF_DATA_POP(d.high);
+    KF_DATA_POP(d.low);
+    d = TwoCellAbs(d);
+    KF_DATA_PUSH(d.low);
+    KF_DATA_PUSH(d.high);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Dtt(kopForth* forth) {  // d1 -- d2
+    TwoCell d;
+    KF_DATA_POP(d.high);
+    KF_DATA_POP(d.low);
+    d = TwoCellAdd(d, d);
+    KF_DATA_PUSH(d.low);
+    KF_DATA_PUSH(d.high);
+    return KF_STATUS_OK;
+}
+
 kfStatus W_Equ(kopForth* forth) {  // n1 n2 -- n
     isize a, b;
     KF_DATA_POP(b);
@@ -460,18 +773,15 @@ kfStatus W_Dqu(kopForth* forth) {  // --
         kfBiosWriteStr(".\" : not imp");
         return KF_SYSTEM_NOT_IMP;
     } else { // Run time
-        while (forth->in_offset < forth->tib_len) {
-            char c = forth->tib[forth->in_offset];
-            forth->in_offset++;
-            if (c == '"')
-                break;
-            kfBiosWriteChar(c);
-        }
+        usize len;
+        uint8_t* str = kfParse(forth, '"', &len);
+        kfBiosWriteStrLen((char*) str, len);
     }
     return KF_STATUS_OK;
 }
 
 kfStatus W_Bye(kopForth* forth) {  // --
+    kfBiosFlush();
     return KF_SYSTEM_DONE;
 }
 
@@ -480,29 +790,35 @@ kfStatus W_Dos(kopForth* forth) {  // --
     return KF_STATUS_OK;
 }
 
+kfStatus W_Dpt(kopForth* forth) {  // -- n
+    KF_DATA_PUSH(kfDataStackDepth(&forth->d_stack));
+    return KF_STATUS_OK;
+}
+
 
 
 // Fill native words into memory.
 void kfPopulateWordsNative(kopForth* forth, kfWordsNative* wn) {
     // TODO Null check.
 
-    wn->ext = kopForthAddNativeWord(forth, "EXIT",      W_Ext, false);  // TODO make compile only.
+    wn->ext = kopForthAddPrimWord(forth,   "EXIT",      W_Ext, false, KF_PRIM_EXT);  // TODO make compile only.
     wn->ext->link = NULL;
-    wn->lit = kopForthAddNativeWord(forth, "(LIT)",     W_Lit, false);  // TODO make compile only.
-    wn->sub = kopForthAddNativeWord(forth, "-",         W_Sub, false);
-    wn->mul = kopForthAddNativeWord(forth, "*",         W_Mul, false);
+    wn->lit = kopForthAddPrimWord(forth,   "(LIT)",     W_Lit, false, KF_PRIM_LIT);  // TODO make compile only.
+    wn->usr = kopForthAddPrimWord(forth,   "(USER)",    W_Usr, false, KF_PRIM_USR);  // TODO make compile only.
+    wn->sub = kopForthAddPrimWord(forth,   "-",         W_Sub, false, KF_PRIM_SUB);
+    wn->mul = kopForthAddPrimWord(forth,   "*",         W_Mul, false, KF_PRIM_MUL);
     wn->dot = kopForthAddNativeWord(forth, ".",         W_Dot, false);
-    wn->att = kopForthAddNativeWord(forth, "@",         W_Att, false);
-    wn->exc = kopForthAddNativeWord(forth, "!",         W_Exc, false);
-    wn->cat = kopForthAddNativeWord(forth, "C@",        W_Cat, false);
-    wn->cex = kopForthAddNativeWord(forth, "C!",        W_Cex, false);
-    wn->rpu = kopForthAddNativeWord(forth, ">R",        W_Rpu, false);
-    wn->rpo = kopForthAddNativeWord(forth, "R>",        W_Rpo, false);
-    wn->drp = kopForthAddNativeWord(forth, "DROP",      W_Drp, false);
-    wn->dup = kopForthAddNativeWord(forth, "DUP",       W_Dup, false);
-    wn->swp = kopForthAddNativeWord(forth, "SWAP",      W_Swp, false);
-    wn->bra = kopForthAddNativeWord(forth, "BRANCH",    W_Bra, false);  // TODO make compile only.
-    wn->zbr = kopForthAddNativeWord(forth, "0BRANCH",   W_Zbr, false);  // TODO make compile only.
+    wn->att = kopForthAddPrimWord(forth,   "@",         W_Att, false, KF_PRIM_ATT);
+    wn->exc = kopForthAddPrimWord(forth,   "!",         W_Exc, false, KF_PRIM_EXC);
+    wn->cat = kopForthAddPrimWord(forth,   "C@",        W_Cat, false, KF_PRIM_CAT);
+    wn->cex = kopForthAddPrimWord(forth,   "C!",        W_Cex, false, KF_PRIM_CEX);
+    wn->rpu = kopForthAddPrimWord(forth,   ">R",        W_Rpu, false, KF_PRIM_RPU);
+    wn->rpo = kopForthAddPrimWord(forth,   "R>",        W_Rpo, false, KF_PRIM_RPO);
+    wn->drp = kopForthAddPrimWord(forth,   "DROP",      W_Drp, false, KF_PRIM_DRP);
+    wn->dup = kopForthAddPrimWord(forth,   "DUP",       W_Dup, false, KF_PRIM_DUP);
+    wn->swp = kopForthAddPrimWord(forth,   "SWAP",      W_Swp, false, KF_PRIM_SWP);
+    wn->bra = kopForthAddPrimWord(forth,   "BRANCH",    W_Bra, false, KF_PRIM_BRA);  // TODO make compile only.
+    wn->zbr = kopForthAddPrimWord(forth,   "0BRANCH",   W_Zbr, false, KF_PRIM_ZBR);  // TODO make compile only.
     wn->emt = kopForthAddNativeWord(forth, "EMIT",      W_Emt, false);
     wn->key = kopForthAddNativeWord(forth, "KEY",       W_Key, false);
     wn->acc = kopForthAddNativeWord(forth, "ACCEPT",    W_Acc, false);
@@ -514,16 +830,33 @@ void kfPopulateWordsNative(kopForth* forth, kfWordsNative* wn) {
     wn->fnd = kopForthAddNativeWord(forth, "FIND",      W_Fnd, false);
     wn->mss = kopForthAddNativeWord(forth, "M*/",       W_Mss, false);
     wn->dpl = kopForthAddNativeWord(forth, "D+",        W_Dpl, false);
-    wn->equ = kopForthAddNativeWord(forth, "=",         W_Equ, false);
-    wn->lss = kopForthAddNativeWord(forth, "<",         W_Lss, false);
-    wn->nan = kopForthAddNativeWord(forth, "NAND",      W_Nan, false);
-    wn->psq = kopForthAddNativeWord(forth, "(S\")",     W_Psq, false);  // TODO make compile only.
+    wn->ums = kopForthAddNativeWord(forth, "UM*",       W_Ums, false);
+    wn->mst = kopForthAddNativeWord(forth, "M*",        W_Mst, false);
+    wn->umm = kopForthAddNativeWord(forth, "UM/MOD",    W_Umm, false);
+    wn->smr = kopForthAddNativeWord(forth, "SM/REM",    W_Smr, false);
+    wn->fmm = kopForthAddNativeWord(forth, "FM/MOD",    W_Fmm, false);
+    wn->div = kopForthAddNativeWord(forth, "/",         W_Div, false);
+    wn->mod = kopForthAddNativeWord(forth, "MOD",       W_Mod, false);
+    wn->dmo = kopForthAddNativeWord(forth, "/MOD",      W_Dmo, false);
+    wn->sts = kopForthAddNativeWord(forth, "*/",        W_Sts, false);
+    wn->ssm = kopForthAddNativeWord(forth, "*/MOD",     W_Ssm, false);
+    wn->dmi = kopForthAddNativeWord(forth, "D-",        W_Dmi, false);
+    wn->dng = kopForthAddNativeWord(forth, "DNEGATE",   W_Dng, false);
+    wn->dls = kopForthAddNativeWord(forth, "D<",        W_Dls, false);
+    wn->deq = kopForthAddNativeWord(forth, "D=",        W_Deq, false);
+    wn->dab = kopForthAddNativeWord(forth, "DABS",      W_Dab, false);
+    wn->dtt = kopForthAddNativeWord(forth, "D2*",       W_Dtt, false);
+    wn->equ = kopForthAddPrimWord(forth,   "=",         W_Equ, false, KF_PRIM_EQU);
+    wn->lss = kopForthAddPrimWord(forth,   "<",         W_Lss, false, KF_PRIM_LSS);
+    wn->nan = kopForthAddPrimWord(forth,   "NAND",      W_Nan, false, KF_PRIM_NAN);
+    wn->psq = kopForthAddPrimWord(forth,   "(S\")",     W_Psq, false, KF_PRIM_THREAD);  // TODO make compile only.
     wn->squ = kopForthAddNativeWord(forth, "S\"",       W_Squ, true );  // TODO make compile only.
     wn->dqu = kopForthAddNativeWord(forth, ".\"",       W_Dqu, true );
     wn->bye = kopForthAddNativeWord(forth, "BYE",       W_Bye, false);
     wn->dos = kopForthAddNativeWord(forth, ".S",        W_Dos, false);
+    wn->dpt = kopForthAddNativeWord(forth, "DEPTH",     W_Dpt, false);
 
-    wn->crs = kopForthAddNativeWord(forth, "(CLR-RET-STACK)", W_Crs, false);
+    wn->crs = kopForthAddPrimWord(forth,   "(CLR-RET-STACK)", W_Crs, false, KF_PRIM_THREAD);
     wn->cds = kopForthAddNativeWord(forth, "(CLR-DAT-STACK)", W_Cds, false);
 }
 
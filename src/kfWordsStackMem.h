@@ -2,8 +2,10 @@
 #define KF_WORDS_STACK_MEM_H
 
 /*
- * kfWordsStackMem.h (last modified 2025-05-29)
+ * kfWordsStackMem.h (last modified 2026-10-18)
  * This contains the word definitions for stack and address operators.
+ * These are built out of a minimal set of native words so they're easy to
+ * port, but defining KF_NATIVE_STACK_MEM swaps them for native versions.
  */
 
 #include "kfType.h"
@@ -23,6 +25,9 @@ struct kfWordsStackMem {
     kfWord* inv;
     kfWord* orr;
     kfWord* and;
+    kfWord* xor;
+    kfWord* lsh;
+    kfWord* rsh;
     kfWord* zeq;
     kfWord* neq;
     kfWord* leq;
@@ -37,11 +42,201 @@ struct kfWordsStackMem {
 
 
 
+// Native word implementations, used when KF_NATIVE_STACK_MEM is defined.
+
+kfStatus W_Ovr(kopForth* forth) {  // n1 n2 -- n1 n2 n1
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a);
+    KF_DATA_PUSH(b);
+    KF_DATA_PUSH(a);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Rot(kopForth* forth) {  // n1 n2 n3 -- n2 n3 n1
+    isize a, b, c;
+    KF_DATA_POP(c);
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(b);
+    KF_DATA_PUSH(c);
+    KF_DATA_PUSH(a);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Tdr(kopForth* forth) {  // n1 n2 --
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Tdu(kopForth* forth) {  // n1 n2 -- n1 n2 n1 n2
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a);
+    KF_DATA_PUSH(b);
+    KF_DATA_PUSH(a);
+    KF_DATA_PUSH(b);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Add(kopForth* forth) {  // n1 n2 -- n3
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a + b);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Inv(kopForth* forth) {  // n1 -- n2
+    isize a;
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(~a);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Orr(kopForth* forth) {  // n1 n2 -- n3
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a | b);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_And(kopForth* forth) {  // n1 n2 -- n3
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a & b);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Xor(kopForth* forth) {  // n1 n2 -- n3
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a ^ b);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Lsh(kopForth* forth) {  // n1 u -- n2
+    isize a;
+    usize u;
+    KF_DATA_POP(u);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH((u >= sizeof(isize) * 8 ? 0 : (usize) a << u));
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Zeq(kopForth* forth) {  // n1 -- n2
+    isize a;
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a == 0 ? -1 : 0);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Neq(kopForth* forth) {  // n1 n2 -- n3
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a != b ? -1 : 0);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Leq(kopForth* forth) {  // n1 n2 -- n3
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a <= b ? -1 : 0);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Gtr(kopForth* forth) {  // n1 n2 -- n3
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a > b ? -1 : 0);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Geq(kopForth* forth) {  // n1 n2 -- n3
+    isize a, b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a >= b ? -1 : 0);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Cls(kopForth* forth) {  // n1 -- n2
+    isize a;
+    KF_DATA_POP(a);
+    KF_DATA_PUSH(a * (isize) sizeof(isize));
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Pex(kopForth* forth) {  // n addr --
+    isize a;
+    isize* b;
+    KF_DATA_POP(b);
+    KF_DATA_POP(a);
+    *b += a;
+    return KF_STATUS_OK;
+}
+
+// This is native in every build, since building it from the other words means
+// taking the high cell of an M*/, which costs hundreds of words a call.
+kfStatus W_Rsh(kopForth* forth) {  // n1 u -- n2
+    isize a;
+    usize u;
+    KF_DATA_POP(u);
+    KF_DATA_POP(a);
+    KF_DATA_PUSH((u >= sizeof(isize) * 8 ? 0 : (usize) a >> u));
+    return KF_STATUS_OK;
+}
+
+// This is native in every build too, since `mem` has to be committed before
+// HERE can move into it.
+kfStatus W_Alt(kopForth* forth) {  // n --
+    isize n;
+    KF_DATA_POP(n);
+    if (n > 0 && !kfCanFitInMem(forth, n))
+        return KF_MEM_FULL;
+    forth->here += n;
+    return KF_STATUS_OK;
+}
+
+
+
 // Fill stack/memory words into memory.
 void kfPopulateWordsStackMem(kopForth* forth, kfWordsNative* wn,
                              kfWordsVarAddrConst* wv, kfWordsStackMem* wm) {
     // TODO Null check.
 
+    #ifdef KF_NATIVE_STACK_MEM
+    // Stack manipulators and operators
+    wm->ovr = kopForthAddPrimWord(forth, "OVER",   W_Ovr, false, KF_PRIM_OVR);  // ( n1 n2 -- n1 n2 n1 )
+    wm->rot = kopForthAddPrimWord(forth, "ROT",    W_Rot, false, KF_PRIM_ROT);  // ( n1 n2 n3 -- n2 n3 n1 )
+    wm->tdr = kopForthAddPrimWord(forth, "2DROP",  W_Tdr, false, KF_PRIM_TDR);  // ( n1 n2 -- )
+    wm->tdu = kopForthAddPrimWord(forth, "2DUP",   W_Tdu, false, KF_PRIM_TDU);  // ( n1 n2 -- n1 n2 n1 n2 )
+    wm->add = kopForthAddPrimWord(forth, "+",      W_Add, false, KF_PRIM_ADD);  // ( n1 n2 -- n3 )
+    wm->inv = kopForthAddPrimWord(forth, "INVERT", W_Inv, false, KF_PRIM_INV);  // ( n1 -- n2 )
+    wm->orr = kopForthAddPrimWord(forth, "OR",     W_Orr, false, KF_PRIM_ORR);  // ( n1 n2 -- n3 )
+    wm->and = kopForthAddPrimWord(forth, "AND",    W_And, false, KF_PRIM_AND);  // ( n1 n2 -- n3 )
+    wm->xor = kopForthAddPrimWord(forth, "XOR",    W_Xor, false, KF_PRIM_XOR);  // ( n1 n2 -- n3 )
+    wm->lsh = kopForthAddPrimWord(forth, "LSHIFT", W_Lsh, false, KF_PRIM_LSH);  // ( n1 u -- n2 )
+    wm->zeq = kopForthAddPrimWord(forth, "0=",     W_Zeq, false, KF_PRIM_ZEQ);  // ( n1 -- n2 )
+    wm->neq = kopForthAddPrimWord(forth, "<>",     W_Neq, false, KF_PRIM_NEQ);  // ( n1 n2 -- n3 )
+    wm->leq = kopForthAddPrimWord(forth, "<=",     W_Leq, false, KF_PRIM_LEQ);  // ( n1 n2 -- n3 )
+    wm->gtr = kopForthAddPrimWord(forth, ">",      W_Gtr, false, KF_PRIM_GTR);  // ( n1 n2 -- n3 )
+    wm->geq = kopForthAddPrimWord(forth, ">=",     W_Geq, false, KF_PRIM_GEQ);  // ( n1 n2 -- n3 )
+
+    // Address manipulators
+    wm->cls = kopForthAddPrimWord(forth, "CELLS",  W_Cls, false, KF_PRIM_CLS);  // ( n -- n )
+    wm->pex = kopForthAddPrimWord(forth, "+!",     W_Pex, false, KF_PRIM_PEX);  // ( n a -- )
+    #else
     // Stack manipulators and operators
     wm->ovr = kopForthAddWord(forth, "OVER");      // ( n1 n2 -- n1 n2 n1 )
         WRD(wn->rpu); WRD(wn->dup);                // >R DUP   ( n1 n1 )
@@ -71,6 +266,29 @@ void kfPopulateWordsStackMem(kopForth* forth, kfWordsNative* wn,
     wm->and = kopForthAddWord(forth, "AND");       // ( n1 n2 -- n3 )
         WRD(wn->nan); WRD(wm->inv);                // NAND INVERT
         WRD(wn->ext);
+    wm->xor = kopForthAddWord(forth, "XOR");       // ( n1 n2 -- n3 )
+        WRD(wm->tdu); WRD(wm->orr); WRD(wn->rpu);  // 2DUP OR >R     ( n1 n2 )
+        WRD(wm->and); WRD(wm->inv);                // AND INVERT     ( n4 )
+        WRD(wn->rpo); WRD(wm->and);                // R> AND         ( n3 )
+        WRD(wn->ext);
+    wm->lsh = kopForthAddWord(forth, "LSHIFT"); {  // ( n1 u -- n2 )
+        // Shifting by the cell width or more gives 0, the same as the native
+        // version, rather than doubling u times.
+        WRD(wn->dup); LIT(~(isize) (sizeof(isize) * 8 - 1));  // DUP [ bits 1 - INVERT ] LITERAL
+        WRD(wm->and); LITADDR(b00, wn->zbr, 0);    // AND IF             ( n1 u )
+        WRD(wm->tdr); LIT(0);                      //     2DROP 0        ( n2 )
+        LITADDR(b01, wn->bra, 0);                  // ELSE
+        WRDADDR(b02, wn->dup);                     //     BEGIN DUP
+        LITADDR(b03, wn->zbr, 0);                  //     WHILE          ( n1 u )
+        WRD(wn->swp); WRD(wn->dup); WRD(wm->add);  //         SWAP DUP + ( u n1 )
+        WRD(wn->swp); LIT(1); WRD(wn->sub);        //         SWAP 1 -   ( n1 u )
+        LITADDR(b04, wn->bra, 0);                  //     REPEAT
+        WRDADDR(b05, wn->drp);                     //     DROP           ( n2 )
+        WRDADDR(b06, wn->ext);                     // THEN EXIT
+        *b00 = (isize) b02;
+        *b01 = (isize) b06;
+        *b03 = (isize) b05;
+        *b04 = (isize) b02; }
     wm->zeq = kopForthAddWord(forth, "0=");        // ( n1 -- n2 )
         WRD(wv->fal); WRD(wn->equ);                // 0 =
         WRD(wn->ext);
@@ -99,9 +317,10 @@ void kfPopulateWordsStackMem(kopForth* forth, kfWordsNative* wn,
         WRD(wn->rpu); WRD(wm->add); WRD(wn->rpo);  // >R + R>  ( n3 a )
         WRD(wn->exc);                              // !
         WRD(wn->ext);
-    wm->alt = kopForthAddWord(forth, "ALLOT");     // ( n -- )
-        WRD(wv->dpt); WRD(wm->pex);                // DP +!
-        WRD(wn->ext);
+    #endif
+
+    wm->rsh = kopForthAddPrimWord(forth, "RSHIFT", W_Rsh, false, KF_PRIM_RSH);  // ( n1 u -- n2 )
+    wm->alt = kopForthAddNativeWord(forth, "ALLOT", W_Alt, false);  // ( n -- )
     wm->com = kopForthAddWord(forth, ",");         // ( n -- )
         WRD(wv->her); WRD(wn->exc);                // HERE !
         LIT(sizeof(isize));                        // [ 1 CELLS ] LITERAL
@@ -2,10 +2,15 @@
 #define KF_WORDS_STRING_H
 
 /*
- * kfWordsString.h (last modified 2025-05-29)
+ * kfWordsString.h (last modified 2026-10-18)
  * This contains the word definitions for string/char related stuff.
+ * Number conversion is native since every number INTERPRET sees goes through
+ * it. It uses BASE, and a number can start with $ (hex), % (binary) or # (decimal).
  */
 
+#include "kfMath.h"
+#include "kfStack.h"
+#include "kfStatus.h"
 #include "kfType.h"
 #include "kfWordsNative.h"
 #include "kfWordsStackMem.h"
@@ -28,11 +33,131 @@ struct kfWordsString {
 
 
 
+// Number conversion.
+
+// The value of the digit `c` in `base`, or -1 if it isn't one.
+isize kfDigit(uint8_t c, isize base) {
+    isize value;
+    if (c >= '0' && c <= '9')
+        value = c - '0';
+    else if (c >= 'A' && c <= 'Z')
+        value = c - 'A' + 10;
+    else if (c >= 'a' && c <= 'z')
+        value = c - 'a' + 10;
+    else
+        return -1;
+    return value < base ? value : -1;
+}
+
+// Adds digits from the string to `ud` until one isn't a digit in `base`, and
+// leaves the string at whatever is left of it, like >NUMBER.
+void kfToNumber(TwoCell* ud, uint8_t** addr, usize* len, isize base) {
+    while (*len > 0) {
+        isize digit = kfDigit(**addr, base);
+        if (digit < 0)
+            return;
+        *ud = TwoCellMulAdd(*ud, base, digit);
+        (*addr)++;
+        (*len)--;
+    }
+}
+
+kfStatus W_Dig(kopForth* forth) {  // char -- n -1 | 0
+    isize c;
+    KF_DATA_POP(c);
+    isize digit = c >= 0 && c <= 255 ? kfDigit(c, forth->base) : -1;
+    if (digit < 0) {
+        KF_DATA_PUSH(0);
+        return KF_STATUS_OK;
+    }
+    KF_DATA_PUSH(digit);
+    KF_DATA_PUSH(-1);
+    return KF_STATUS_OK;
+}
+
+kfStatus W_Num(kopForth* forth) {  // ud1 a1 u1 -- ud2 a2 u2
+    TwoCell ud;
+    uint8_t* addr;
+    usize len;
+    KF_DATA_POP(len);
+    KF_DATA_POP(addr);
+    KF_DATA_POP(ud.high);
+    KF_DATA_POP(ud.low);
+    kfToNumber(&ud, &addr, &len, forth->base);
+    KF_DATA_PUSH(ud.low);
+    KF_DATA_PUSH(ud.high);
+    KF_DATA_PUSH(addr);
+    KF_DATA_PUSH(len);
+    return KF_STATUS_OK;
+}
+
+// A number is an optional base prefix, an optional -, then digits. A trailing
+// . makes it a double. If it isn't a number, the unconverted part of the
+// string is left, which is never empty.
+kfStatus W_Snu(kopForth* forth) {  // a1 u1 -- n 0 0 | d -1 0 | a2 u2
+    uint8_t* addr;
+    usize len;
+    KF_DATA_POP(len);
+    KF_DATA_POP(addr);
+    uint8_t* start = addr;
+    usize start_len = len;
+    bool is_double = len > 0 && addr[len - 1] == '.';
+    if (is_double)
+        len--;
+    isize base = forth->base;
+    if (len > 0) {
+        switch (*addr) {
+            case '#': base = 10; break;
+            case '$': base = 16; break;
+            case '%': base = 2;  break;
+            default:  base = 0;  break;
+        }
+        if (base != 0) {
+            addr++;
+            len--;
+        } else {
+            base = forth->base;
+        }
+    }
+    bool is_negative = len > 0 && *addr == '-';
+    if (is_negative) {
+        addr++;
+        len--;
+    }
+    if (len == 0 && start_len > 0) {
+        // Just a prefix, sign or dot without any digits.
+        KF_DATA_PUSH(start);
+        KF_DATA_PUSH(start_len);
+        return KF_STATUS_OK;
+    }
+    TwoCell d = {0, 0};
+    kfToNumber(&d, &addr, &len, base);
+    if (len != 0) {
+        KF_DATA_PUSH(addr);
+        KF_DATA_PUSH(len);
+        return KF_STATUS_OK;
+    }
+    if (is_negative)
+        d = TwoCellNegate(d);
+    KF_DATA_PUSH(d.low);
+    if (is_double) {
+        KF_DATA_PUSH(d.high);
+        KF_DATA_PUSH(-1);
+    } else {
+        KF_DATA_PUSH(0);
+    }
+    KF_DATA_PUSH(0);
+    return KF_STATUS_OK;
+}
+
+
+
 // Fill string words into memory.
 void kfPopulateWordsString(kopForth* forth, kfWordsNative* wn,
                            kfWordsVarAddrConst* wv, kfWordsStackMem* wm,
                            kfWordsString* ws) {
     // TODO Null check.
+    (void) wv;  // Kept so every kfPopulate function takes the same word sets.
 
     ws->crr = kopForthAddWord(forth, "CR");        // ( -- )
         LIT(KF_NL); WRD(wn->emt);                  // 10 EMIT
@@ -53,81 +178,9 @@ void kfPopulateWordsString(kopForth* forth, kfWordsNative* wn,
         WRD(wn->swp); WRD(wn->rpo); WRD(wn->sub);  // SWAP R> -  ( a2 u2 )
         WRD(wn->ext);
 
-    ws->dig = kopForthAddWord(forth, "DIGIT?"); {           // ( n1 -- n2 -1 | 0 )
-        LIT(48); WRD(wn->sub);                              // 48 -            ( n2 )
-        WRD(wn->dup); LIT(0); WRD(wn->lss);                 // DUP 0 <         ( n2 f1 )
-        WRD(wm->ovr); LIT(10); WRD(wm->geq);                // OVER 10 >=      ( n2 f1 f2 )
-        WRD(wm->orr); LITADDR(b00, wn->zbr, 0);             // OR IF           ( n2 )
-        WRD(wn->drp); WRD(wv->fal);                         //     DROP FALSE  ( 0 )
-        LITADDR(b01, wn->bra, 0);                           // ELSE
-        WRDADDR(b02, wv->tru);                              //     TRUE        ( n2 -1 )
-        WRDADDR(b03, wn->ext);                              // THEN
-        *b00 = (isize) b02;
-        *b01 = (isize) b03; }
-    ws->num = kopForthAddWord(forth, ">NUMBER"); {          // ( ud1 a1 u1 -- ud2 a2 u2 )
-        kfWord** b00 =                                      // BEGIN
-        WRD(wn->dup); WRD(wm->zeq);                         //     DUP 0=           ( ud a u f )
-        LITADDR(b01, wn->zbr, 0);                           //     IF               ( ud a u )
-        WRD(wn->ext);                                       //         EXIT THEN
-        WRDADDR(b02, wm->ovr); WRD(wn->cat); WRD(ws->dig);  //     OVER C@ DIGIT?   ( ud a u n f )
-        LITADDR(b03, wn->zbr, 0);                           //     IF               ( ud a u n )
-        WRD(wn->swp); LIT(1); WRD(wn->sub); WRD(wn->rpu);   //         SWAP 1 - >R  ( ud a n )
-        WRD(wn->swp); LIT(1); WRD(wm->add); WRD(wn->rpu);   //         SWAP 1 + >R  ( ud n )
-        WRD(wn->rpu);                                       //         >R           ( ud )
-        LIT(10); LIT(1); WRD(wn->mss);                      //         10 1 M*/     ( ud )
-        WRD(wn->rpo); LIT(0); WRD(wn->dpl);                 //         R> 0 D+      ( ud )
-        WRD(wn->rpo); WRD(wn->rpo);                         //         R> R>        ( ud a u )
-        LITADDR(b04, wn->bra, 0);                           //     ELSE
-        WRDADDR(b05, wn->ext);                              //         EXIT THEN
-        WRDADDR(b06, wn->bra); RAWADDR(b07, 0);             // AGAIN
-        WRD(wn->ext);
-        *b01 = (isize) b02;
-        *b03 = (isize) b05;
-        *b04 = (isize) b06;
-        *b07 = (isize) b00; }
-    ws->snu = kopForthAddWord(forth, "S>NUMBER?"); {        // ( a1 u1 -- n 0 0 | d -1 0 | a2 u2 )
-        // \ Save double status (true if need to drop high word)
-        WRD(wm->tdu); WRD(wm->add); LIT(1); WRD(wn->sub);   // 2DUP + 1 -
-        WRD(wn->cat); LIT('.'); WRD(wn->equ);               // C@ [CHAR] . =
-        LITADDR(b00, wn->zbr, 0);                           // IF
-        WRD(wv->fal); WRD(wn->rpu);                         //     FALSE >R
-        LIT(1); WRD(wn->sub);                               //     1 -
-        LITADDR(b01, wn->bra, 0);                           // ELSE
-        WRDADDR(b02, wv->tru); WRD(wn->rpu);                //     TRUE >R THEN
-        // \ Save sign multiplier
-        WRDADDR(b03, wm->ovr); WRD(wn->cat);                // OVER C@
-        LIT('-'); WRD(wn->equ);                             // [CHAR] - =
-        LITADDR(b04, wn->zbr, 0);                           // IF
-        LIT(-1); WRD(wn->rpu);                              //     -1 >R
-        LIT(1); WRD(ws->sst);                               //     1 /STRING
-        LITADDR(b05, wn->bra, 0);                           // ELSE
-        WRDADDR(b06, wn->lit); RAW(1); WRD(wn->rpu);        //     1 >R THEN
-        // \ Add 0. to beginning of stack and parse number
-        WRDADDR(b07, wn->rpu); WRD(wn->rpu);                // >R >R
-        LIT(0); LIT(0); WRD(wn->rpo); WRD(wn->rpo);         // 0. R> R>           ( 0. a u )
-        WRD(ws->num);                                       // >NUMBER            ( ud a u )
-        // \ Check that the parsing was good
-        WRD(wn->dup); WRD(wm->zeq);                         // DUP 0=
-        LITADDR(b08, wn->zbr, 0);                           // IF  \ Success
-        WRD(wm->tdr);                                       //     2DROP          ( ud )
-        WRD(wn->rpo); LIT(1); WRD(wn->mss);                 //     R> 1 M*/       ( d )
-        WRD(wn->rpo); LITADDR(b09, wn->zbr, 0);             //     R> IF
-        WRD(wn->drp); LIT(0); LIT(0);                       //         DROP 0 0   ( n 0 0 )
-        LITADDR(b10, wn->bra, 0);                           //     ELSE
-        WRDADDR(b11, wn->lit); RAW(-1); LIT(0);             //         -1 0 THEN  ( d -1 0 )
-        WRDADDR(b12, wn->bra); RAWADDR(b13, 0);             // ELSE  \ Failure
-        WRDADDR(b14, wn->rpu); WRD(wn->rpu);                //     >R >R
-        WRD(wm->tdr); WRD(wn->rpo); WRD(wn->rpo);           //     2DROP R> R>    ( addr u )
-        WRD(wn->rpo); WRD(wn->rpo); WRD(wm->tdr);           //     R> R> 2DROP
-        WRDADDR(b15, wn->ext);                              // THEN EXIT
-        *b00 = (isize) b02;
-        *b01 = (isize) b03;
-        *b04 = (isize) b06;
-        *b05 = (isize) b07;
-        *b08 = (isize) b14;
-        *b09 = (isize) b11;
-        *b10 = (isize) b12;
-        *b13 = (isize) b15; }
+    ws->dig = kopForthAddNativeWord(forth, "DIGIT?",    W_Dig, false);  // ( char -- n -1 | 0 )
+    ws->num = kopForthAddNativeWord(forth, ">NUMBER",   W_Num, false);  // ( ud1 a1 u1 -- ud2 a2 u2 )
+    ws->snu = kopForthAddNativeWord(forth, "S>NUMBER?", W_Snu, false);  // ( a1 u1 -- n 0 0 | d -1 0 | a2 u2 )
 }
 
 #endif // KF_WORDS_STRING_H
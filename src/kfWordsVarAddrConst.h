@@ -2,7 +2,7 @@
 #define KF_WORDS_VAR_ADDR_CONST_H
 
 /*
- * kfWordsVarAddrConst.h (last modified 2025-06-12)
+ * kfWordsVarAddrConst.h (last modified 2026-10-17)
  * This contains the word definitions for variables, addresses, and constants.
  */
 
@@ -22,11 +22,14 @@ struct kfWordsVarAddrConst {
     kfWord* ppt;
     kfWord* sta;
     kfWord* dbg;
+    kfWord* bas;
     kfWord* her;
     kfWord* lat;
     kfWord* pad;
     kfWord* tru;
     kfWord* fal;
+    kfWord* hex;
+    kfWord* dec;
 };
 
 
@@ -45,6 +48,7 @@ void kfPopulateWordsVarAddrConst(kopForth* forth, kfWordsNative* wn,
     wv->ppt = kopForthAddVariable(forth, "PP",    (isize*) &forth->pending);    // -- a
     wv->sta = kopForthAddVariable(forth, "STATE", (isize*) &forth->state);      // -- a
     wv->dbg = kopForthAddVariable(forth, "DEBUG", (isize*) &forth->debug);      // -- a
+    wv->bas = kopForthAddVariable(forth, "BASE",  (isize*) &forth->base);       // -- a
 
     // Addresses
     wv->her = kopForthAddWord(forth, "HERE");    // ( -- a )s
@@ -64,6 +68,14 @@ void kfPopulateWordsVarAddrConst(kopForth* forth, kfWordsNative* wn,
     wv->fal = kopForthAddWord(forth, "FALSE");  // ( -- 0 )
         LIT(0);
         WRD(wn->ext);
+
+    // Radix
+    wv->hex = kopForthAddWord(forth, "HEX");      // ( -- )
+        LIT(16); WRD(wv->bas); WRD(wn->exc);      // 16 BASE !
+        WRD(wn->ext);
+    wv->dec = kopForthAddWord(forth, "DECIMAL");  // ( -- )
+        LIT(10); WRD(wv->bas); WRD(wn->exc);      // 10 BASE !
+        WRD(wn->ext);
 }
 
 
@@ -2,12 +2,24 @@
 #define KOP_FORTH_H
 
 /*
- * kopForth.h (last modified 2025-06-12)
+ * kopForth.h (last modified 2026-10-18)
  * This is the main kopForth file that gets included and pulls in all the
  * dependencies. It also includes the initialization and run routines.
+ * Build with KF_DIRECT_THREADED defined to have kopForthRun use the
+ * direct-threaded inner interpreter.
+ * kopForthLoadImage can be used instead of kopForthInit to start from an image
+ * saved by SAVE-IMAGE.
+ * kopForthClone starts a system that shares the dictionary of another one.
+ * Build with KF_PREBUILT_KERNEL defined to use the kernel dictionary in
+ * kfKernel.h (made by kfGen.c) instead of building it in `mem` at startup.
  */
 
 #include "kfBios.h"
+#include "kfDict.h"
+#include "kfImage.h"
+#ifdef KF_PREBUILT_KERNEL
+    #include "kfKernel.h"
+#endif
 #include "kfStack.h"
 #include "kfType.h"
 #include "kfWordsIntComp.h"
@@ -16,11 +28,23 @@
 #include "kfWordsString.h"
 #include "kfWordsVarAddrConst.h"
 
+#ifdef KF_PREBUILT_KERNEL
+    #if KF_KERNEL_UINTPTR_MAX != UINTPTR_MAX || KF_KERNEL_MAX_NAME_SIZE != KF_MAX_NAME_SIZE || \
+        KF_KERNEL_FUSE_RULES != KF_FUSE_RULES || KF_KERNEL_FOLD_RULES != KF_FOLD_RULES || \
+        KF_KERNEL_NATIVE_STACK_MEM != defined(KF_NATIVE_STACK_MEM)
+        #error "kfKernel.h was generated for a different build, run kfGen again"
+    #endif
+#endif
+
 
 
 kfStatus kfPopulateWords(kopForth* forth) {
     // TODO Null check
 
+    // The superinstructions don't exist until the compiler words are added.
+    forth->debug_words.lad = NULL;
+    forth->debug_words.dzb = NULL;
+
     // Native words
     kfWordsNative wn;
     kfPopulateWordsNative(forth, &wn);
@@ -30,6 +54,7 @@ kfStatus kfPopulateWords(kopForth* forth) {
     forth->debug_words.zbr = wn.zbr;
     forth->debug_words.typ = wn.typ;
     forth->debug_words.psq = wn.psq;
+    forth->debug_words.usr = wn.usr;
 
     // Variables, addresses, and constants
     kfWordsVarAddrConst wv;
@@ -47,6 +72,12 @@ kfStatus kfPopulateWords(kopForth* forth) {
     kfWordsIntComp wi;
     kfPopulateWordsIntComp(forth, &wn, &wv, &wm, &ws, &wi);
     forth->debug_words.abt = wi.abt;
+    forth->debug_words.evl = wi.evl;
+    forth->debug_words.evd = wi.evd;
+
+    // Image words
+    kfWordsImage wg;
+    kfPopulateWordsImage(forth, &wg);
 
     /* Example word definition
     kfWord* cou_word = kopForthAddWord(forth, "CNT"); {
@@ -81,7 +112,10 @@ void kfDebug(kopForth* forth) {
     kfBiosWriteChar(' ');
     if (cur_word == forth->debug_words.lit ||
         cur_word == forth->debug_words.bra ||
-        cur_word == forth->debug_words.zbr) {
+        cur_word == forth->debug_words.zbr ||
+        cur_word == forth->debug_words.lad ||
+        cur_word == forth->debug_words.dzb ||
+        cur_word == forth->debug_words.usr) {
         kfBiosWriteChar('(');
         kfBiosPrintIsize(*(isize*)(*forth->r_stack.ptr));
         kfBiosWriteStr(") ");
@@ -92,6 +126,459 @@ void kfDebug(kopForth* forth) {
     kfBiosWriteChar('>'); kfBiosCR();
 }
 
+// Runs a single word, without any of the debugger checks.
+kfStatus kfStep(kopForth* forth) {
+    kfWord* cur_word = (kfWord*) forth->pc;
+    if (cur_word->flags.bit_flags.is_native) {
+        KF_RETURN_IF_ERROR(cur_word->word_def.native(forth));
+        KF_RETURN_IF_ERROR(kfRetnStackPop(&forth->r_stack, (void**) &forth->pc));
+    } else {
+        forth->pc = (uint8_t*) cur_word->word_def.forth;
+    }
+    KF_RETURN_IF_ERROR(kfRetnStackPush(&forth->r_stack, forth->pc + sizeof(kfWord*)));
+    forth->pc = *(uint8_t**) forth->pc;
+    return KF_STATUS_OK;
+}
+
+#ifdef KF_DIRECT_THREADED
+// The fast inner interpreter dispatches on the kfPrim of each native through a
+// table of label addresses when the compiler supports it (GCC and Clang), and
+// through a switch otherwise. Define KF_NO_COMPUTED_GOTO to force the switch.
+#if defined(__GNUC__) && !defined(KF_NO_COMPUTED_GOTO)
+    #define KF_COMPUTED_GOTO
+#endif
+
+#ifdef KF_COMPUTED_GOTO
+    #define KF_VM_CASE(prim)  L_##prim:
+    #define KF_VM_LABEL(prim) [prim] = &&L_##prim
+#else
+    #define KF_VM_CASE(prim)  case prim:
+#endif
+// Helpers for the stack checks and moving on to the next word.
+#define KF_VM_NEED(k)  if (sp + (k) > sp_empty) { s = KF_DATA_STACK_UNDERFLOW; goto leave; }
+#define KF_VM_ROOM(k)  if (sp - (k) < sp_full) { s = KF_DATA_STACK_OVERFLOW; goto leave; }
+#define KF_VM_RNEED(k) if (rp + (k) > rp_empty) { s = KF_RETN_STACK_UNDERFLOW; goto leave; }
+#define KF_VM_RROOM(k) if (rp - (k) < rp_full) { s = KF_RETN_STACK_OVERFLOW; goto leave; }
+#define KF_VM_NEXT     w = *ip++; goto next
+
+// Runs the inner interpreter with the instruction pointer and both stack
+// pointers kept in locals. The core primitives are run inline, so the return
+// stack is only touched for colon definition nesting and by words like `>R`
+// that actually use it. The top of the data stack is cached in `tos`, and the
+// cell at `sp` is only written when something gets pushed on top of it, so
+// `DUP` and `SWAP` barely touch memory. Other natives are called through their
+// function pointer with the stacks (and `tos`) synced before and after, so they
+// always see a regular stack. Runs up to `budget` words,
+// or until a word returns a status other than OK or turns debugging on. The
+// state is handed back in the same form that kfStep uses, so both can be mixed
+// freely.
+kfStatus kfRunDirect(kopForth* forth, usize budget, usize* ticks) {
+    *ticks = 0;
+    if (budget == 0)
+        return KF_STATUS_OK;
+    // The first word run from a fresh start doesn't have a return address yet,
+    // so let the regular step set that up.
+    if (kfRetnStackEmpty(&forth->r_stack)) {
+        *ticks = 1;
+        return kfStep(forth);
+    }
+    #ifdef KF_COMPUTED_GOTO
+        static void* prims[] = {
+            KF_VM_LABEL(KF_PRIM_NONE), KF_VM_LABEL(KF_PRIM_THREAD),
+            KF_VM_LABEL(KF_PRIM_EXT),  KF_VM_LABEL(KF_PRIM_LIT),
+            KF_VM_LABEL(KF_PRIM_BRA),  KF_VM_LABEL(KF_PRIM_ZBR),
+            KF_VM_LABEL(KF_PRIM_RPU),  KF_VM_LABEL(KF_PRIM_RPO),
+            KF_VM_LABEL(KF_PRIM_SUB),  KF_VM_LABEL(KF_PRIM_MUL),
+            KF_VM_LABEL(KF_PRIM_ATT),  KF_VM_LABEL(KF_PRIM_EXC),
+            KF_VM_LABEL(KF_PRIM_CAT),  KF_VM_LABEL(KF_PRIM_CEX),
+            KF_VM_LABEL(KF_PRIM_DRP),  KF_VM_LABEL(KF_PRIM_DUP),
+            KF_VM_LABEL(KF_PRIM_SWP),  KF_VM_LABEL(KF_PRIM_EQU),
+            KF_VM_LABEL(KF_PRIM_LSS),  KF_VM_LABEL(KF_PRIM_NAN),
+            KF_VM_LABEL(KF_PRIM_OVR),  KF_VM_LABEL(KF_PRIM_ROT),
+            KF_VM_LABEL(KF_PRIM_TDR),  KF_VM_LABEL(KF_PRIM_TDU),
+            KF_VM_LABEL(KF_PRIM_ADD),  KF_VM_LABEL(KF_PRIM_INV),
+            KF_VM_LABEL(KF_PRIM_ORR),  KF_VM_LABEL(KF_PRIM_AND),
+            KF_VM_LABEL(KF_PRIM_XOR),  KF_VM_LABEL(KF_PRIM_LSH),
+            KF_VM_LABEL(KF_PRIM_RSH),  KF_VM_LABEL(KF_PRIM_ZEQ),
+            KF_VM_LABEL(KF_PRIM_NEQ),  KF_VM_LABEL(KF_PRIM_LEQ),
+            KF_VM_LABEL(KF_PRIM_GTR),  KF_VM_LABEL(KF_PRIM_GEQ),
+            KF_VM_LABEL(KF_PRIM_CLS),  KF_VM_LABEL(KF_PRIM_PEX),
+            KF_VM_LABEL(KF_PRIM_LAD),  KF_VM_LABEL(KF_PRIM_DZB),
+            KF_VM_LABEL(KF_PRIM_RRO),  KF_VM_LABEL(KF_PRIM_NIP),
+            KF_VM_LABEL(KF_PRIM_USR),
+        };
+    #endif
+    kfStatus s = KF_STATUS_OK;
+    usize n = 0;
+    isize a;
+    isize* sp = forth->d_stack.ptr;
+    isize tos = *sp;
+    isize* sp_empty = &forth->d_stack.data[KF_DATA_STACK_SIZE];
+    isize* sp_full = forth->d_stack.data;
+    void** rp = forth->r_stack.ptr;
+    void** rp_empty = &forth->r_stack.data[KF_RETN_STACK_SIZE];
+    void** rp_full = forth->r_stack.data;
+    kfWord* w = (kfWord*) forth->pc;
+    kfWord** ip = (kfWord**) *rp++;
+
+next:
+    if (n == budget)
+        goto leave;
+    n++;
+    if (!w->flags.bit_flags.is_native) {
+        KF_VM_RROOM(1);
+        *--rp = ip;
+        ip = (kfWord**) ((uint8_t*) w + sizeof(kfWord) - sizeof(kfWordDef));
+        KF_VM_NEXT;
+    }
+    #ifdef KF_COMPUTED_GOTO
+        goto *prims[kfNativePrim(w)];
+    #else
+        switch (kfNativePrim(w)) {
+    #endif
+    KF_VM_CASE(KF_PRIM_EXT)
+        KF_VM_RNEED(1);
+        ip = (kfWord**) *rp++;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_LIT)
+        KF_VM_ROOM(1);
+        *sp-- = tos;
+        tos = *(isize*) ip++;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_USR)
+        KF_VM_ROOM(1);
+        *sp-- = tos;
+        tos = (isize) forth + *(isize*) ip++;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_BRA)
+        ip = *(kfWord***) ip;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_ZBR)
+        KF_VM_NEED(1);
+        ip = tos == 0 ? *(kfWord***) ip : ip + 1;
+        tos = *++sp;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_RPU)
+        KF_VM_NEED(1);
+        KF_VM_RROOM(1);
+        *--rp = (void*) tos;
+        tos = *++sp;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_RPO)
+        KF_VM_RNEED(1);
+        KF_VM_ROOM(1);
+        *sp-- = tos;
+        tos = (isize) *rp++;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_SUB)
+        KF_VM_NEED(2);
+        tos = *++sp - tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_MUL)
+        KF_VM_NEED(2);
+        tos = *++sp * tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_ATT)
+        KF_VM_NEED(1);
+        tos = *(isize*) tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_EXC)
+        KF_VM_NEED(2);
+        *(isize*) tos = sp[1];
+        sp += 2;
+        tos = *sp;
+        // Storing is the only inline way to turn on debugging, along with `C!`
+        // and `+!`.
+        if (forth->debug) {
+            w = *ip++;
+            goto leave;
+        }
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_CAT)
+        KF_VM_NEED(1);
+        tos = *(uint8_t*) tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_CEX)
+        KF_VM_NEED(2);
+        *(uint8_t*) tos = sp[1];
+        sp += 2;
+        tos = *sp;
+        if (forth->debug) {
+            w = *ip++;
+            goto leave;
+        }
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_DRP)
+        KF_VM_NEED(1);
+        tos = *++sp;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_DUP)
+        KF_VM_NEED(1);
+        KF_VM_ROOM(1);
+        *sp-- = tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_SWP)
+        KF_VM_NEED(2);
+        a = sp[1];
+        sp[1] = tos;
+        tos = a;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_EQU)
+        KF_VM_NEED(2);
+        tos = *++sp == tos ? -1 : 0;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_LSS)
+        KF_VM_NEED(2);
+        tos = *++sp < tos ? -1 : 0;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_NAN)
+        KF_VM_NEED(2);
+        tos = ~(*++sp & tos);
+        KF_VM_NEXT;
+    // The rest only show up when built with KF_NATIVE_STACK_MEM.
+    KF_VM_CASE(KF_PRIM_OVR)
+        KF_VM_NEED(2);
+        KF_VM_ROOM(1);
+        *sp-- = tos;
+        tos = sp[2];
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_ROT)
+        KF_VM_NEED(3);
+        a = sp[2];
+        sp[2] = sp[1];
+        sp[1] = tos;
+        tos = a;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_TDR)
+        KF_VM_NEED(2);
+        sp += 2;
+        tos = *sp;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_TDU)
+        KF_VM_NEED(2);
+        KF_VM_ROOM(2);
+        a = sp[1];
+        *sp-- = tos;
+        *sp-- = a;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_ADD)
+        KF_VM_NEED(2);
+        tos = *++sp + tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_INV)
+        KF_VM_NEED(1);
+        tos = ~tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_ORR)
+        KF_VM_NEED(2);
+        tos = *++sp | tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_AND)
+        KF_VM_NEED(2);
+        tos = *++sp & tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_XOR)
+        KF_VM_NEED(2);
+        tos = *++sp ^ tos;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_LSH)
+        KF_VM_NEED(2);
+        a = *++sp;
+        tos = (usize) tos >= sizeof(isize) * 8 ? 0 : (isize) ((usize) a << tos);
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_RSH)
+        KF_VM_NEED(2);
+        a = *++sp;
+        tos = (usize) tos >= sizeof(isize) * 8 ? 0 : (isize) ((usize) a >> tos);
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_ZEQ)
+        KF_VM_NEED(1);
+        tos = tos == 0 ? -1 : 0;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_NEQ)
+        KF_VM_NEED(2);
+        tos = *++sp != tos ? -1 : 0;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_LEQ)
+        KF_VM_NEED(2);
+        tos = *++sp <= tos ? -1 : 0;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_GTR)
+        KF_VM_NEED(2);
+        tos = *++sp > tos ? -1 : 0;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_GEQ)
+        KF_VM_NEED(2);
+        tos = *++sp >= tos ? -1 : 0;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_CLS)
+        KF_VM_NEED(1);
+        tos *= sizeof(isize);
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_PEX)
+        KF_VM_NEED(2);
+        *(isize*) tos += sp[1];
+        sp += 2;
+        tos = *sp;
+        if (forth->debug) {
+            w = *ip++;
+            goto leave;
+        }
+        KF_VM_NEXT;
+    // Superinstructions from COMPILE,
+    KF_VM_CASE(KF_PRIM_LAD)
+        KF_VM_NEED(1);
+        tos += *(isize*) ip++;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_DZB)
+        KF_VM_NEED(1);
+        ip = tos == 0 ? *(kfWord***) ip : ip + 1;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_RRO)
+        KF_VM_RNEED(2);
+        KF_VM_ROOM(2);
+        *sp-- = tos;
+        *sp-- = (isize) rp[0];
+        tos = (isize) rp[1];
+        rp += 2;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_NIP)
+        KF_VM_NEED(2);
+        sp++;
+        KF_VM_NEXT;
+    KF_VM_CASE(KF_PRIM_THREAD)
+        // The word expects the return address on top of the return stack, like
+        // kfStep leaves it.
+        KF_VM_RROOM(1);
+        *--rp = ip;
+        *sp = tos;
+        forth->d_stack.ptr = sp;
+        forth->r_stack.ptr = rp;
+        s = w->word_def.native(forth);
+        sp = forth->d_stack.ptr;
+        rp = forth->r_stack.ptr;
+        tos = *sp;
+        if (!kfStatusIsOk(s)) {
+            *ticks = n;
+            forth->pc = (uint8_t*) w;
+            return s;
+        }
+        ip = (kfWord**) *rp++;
+        w = *ip++;
+        if (forth->debug)
+            goto leave;
+        goto next;
+    KF_VM_CASE(KF_PRIM_NONE)
+    #ifndef KF_COMPUTED_GOTO
+        default:
+    #endif
+        *sp = tos;
+        forth->d_stack.ptr = sp;
+        forth->r_stack.ptr = rp;
+        s = w->word_def.native(forth);
+        sp = forth->d_stack.ptr;
+        rp = forth->r_stack.ptr;
+        tos = *sp;
+        if (!kfStatusIsOk(s))
+            goto leave;
+        w = *ip++;
+        // Only natives and `!` can turn on debugging, so those are the only
+        // places it needs to be checked.
+        if (forth->debug)
+            goto leave;
+        goto next;
+    #ifndef KF_COMPUTED_GOTO
+        }
+    #endif
+
+leave:
+    *ticks = n;
+    *sp = tos;
+    forth->d_stack.ptr = sp;
+    forth->r_stack.ptr = rp;
+    forth->pc = (uint8_t*) w;
+    KF_RETN_PUSH(ip);
+    return s;
+}
+#endif
+
+// Reserves `mem` and sets up everything but the dictionary.
+kfStatus kfInitSystem(kopForth* forth, usize mem_size) {
+    forth->mem = kfBiosMemReserve(mem_size + KF_MEM_HEADROOM);
+    if (forth->mem == NULL)
+        return KF_MEM_FULL;
+    forth->mem_size = mem_size;
+    forth->mem_committed = 0;
+    forth->here = forth->mem;
+    if (!kfMemCommit(forth, 0)) {
+        kfBiosMemRelease(forth->mem, mem_size + KF_MEM_HEADROOM);
+        return KF_MEM_FULL;
+    }
+    forth->latest = NULL;
+    forth->pending = NULL;
+    forth->cpl_last = NULL;
+    forth->cpl_lits = NULL;
+    forth->cpl_tail = NULL;
+    #ifdef KF_HASHED_FIND
+        kfDictReset(forth);
+    #endif
+    forth->state = false;
+    #ifdef KF_DEBUG
+        forth->debug = true;
+    #else
+        forth->debug = false;
+    #endif
+    forth->base = 10;
+    #ifdef KF_PREBUILT_KERNEL
+        forth->kernel = (uint8_t*) &kfKernel;
+        forth->kernel_size = sizeof(kfKernel);
+    #else
+        forth->kernel = NULL;
+        forth->kernel_size = 0;
+    #endif
+    forth->parent = NULL;
+
+    // Initialize stacks.
+    kfDataStackInit(&forth->d_stack);
+    kfRetnStackInit(&forth->r_stack);
+
+    // Setup terminal input buffer. Nothing reads past `tib_len`, so it isn't
+    // cleared.
+    forth->tib_len = 0;
+    forth->in_offset = 0;
+    forth->source = forth->tib;
+    forth->source_len = 0;
+    forth->source_id = 0;
+    forth->source_depth = 0;
+    forth->host_eval = false;
+    forth->included_count = 0;
+    return KF_STATUS_OK;
+}
+
+#ifdef KF_PREBUILT_KERNEL
+// Points the system at the kernel in kfKernel.h instead of building it.
+void kfKernelInit(kopForth* forth) {
+    forth->pending = KF_KERNEL_LATEST;
+    forth->debug_words = kfKernelDebugWords;
+    for (usize i = 0; i < KF_FUSE_RULES; i++)
+        forth->fuse_rules[i] = kfKernelFuseRules[i];
+    for (usize i = 0; i < KF_FOLD_RULES; i++)
+        forth->fold_rules[i] = kfKernelFoldRules[i];
+}
+#endif
+
+void kfPrintMemUsage(kopForth* forth) {
+    kfBiosPrintIsize(forth->here - forth->mem);
+    kfBiosWriteStr(" bytes used of ");
+    kfBiosPrintIsize(forth->mem_size);
+    if (forth->kernel != NULL) {
+        kfBiosWriteStr(", kernel is ");
+        kfBiosPrintIsize(forth->kernel_size);
+        kfBiosWriteStr(" bytes");
+    }
+    kfBiosCR();
+}
+
 //////////////////////////////////
 // Internal functions         ▲ //
 //////////////////////////////////
@@ -160,44 +647,93 @@ kfStatus kopForthTest() {
         kfBiosWriteStr("Bad `is_immediate` position in kfWordFlags"); kfBiosCR();
         return KF_TEST_STRUCT;
     }
+    word.flags.raw_flags = 0;
+    // Test that the inline flag is in the right place.
+    word.flags.bit_flags.is_inline = 1;
+    if (word.flags.raw_flags != 0b00000100) {
+        kfBiosWriteStr("Bad `is_inline` position in kfWordFlags"); kfBiosCR();
+        return KF_TEST_STRUCT;
+    }
 
     return KF_STATUS_OK;
 }
 
-kfStatus kopForthInit(kopForth* forth) {
-    // Setup memory and system variables.
-    for (usize i = 0; i < KF_MEM_SIZE; i++)
-        forth->mem[i] = 0;
-    forth->here = forth->mem;
-    forth->latest = NULL;
-    forth->pending = NULL;
-    forth->state = false;
-    #ifdef KF_DEBUG
-        forth->debug = true;
-    #else
-        forth->debug = false;
-    #endif
-
-    // Initialize stacks.
-    kfDataStackInit(&forth->d_stack);
-    kfRetnStackInit(&forth->r_stack);
+// Releases the memory of a system started by any of the functions below. A
+// system's clones have to be freed before it is.
+void kopForthFree(kopForth* forth) {
+    while (forth->source_depth > 0)
+        kfSourcePop(forth);
+    if (forth->mem != NULL)
+        kfBiosMemRelease(forth->mem, forth->mem_size + KF_MEM_HEADROOM);
+    forth->mem = NULL;
+}
 
-    // Setup terminal input buffer.
-    for (usize i = 0; i < KF_TIB_SIZE; i++)
-        forth->tib[i] = 0;
-    forth->tib_len = 0;
-    forth->in_offset = 0;
+// Initializes the system with room for `mem_size` bytes of words and data. The
+// memory is only reserved up front, and gets committed as the dictionary grows.
+// Without KF_PREBUILT_KERNEL the kernel gets built in `mem`, so it's always at
+// least KF_MEM_SIZE. kopForthFree releases it.
+kfStatus kopForthInitSized(kopForth* forth, usize mem_size) {
+    #ifndef KF_PREBUILT_KERNEL
+        if (mem_size < KF_MEM_SIZE)
+            mem_size = KF_MEM_SIZE;
+    #endif
+    // Setup memory and system variables.
+    KF_RETURN_IF_ERROR(kfInitSystem(forth, mem_size));
 
     // Initialize the word dictionary.
-    KF_RETURN_IF_ERROR(kfPopulateWords(forth));
+    #ifdef KF_PREBUILT_KERNEL
+        kfKernelInit(forth);
+    #else
+        KF_RETURN_IF_ERROR(kfPopulateWords(forth));
+    #endif
     forth->latest = forth->pending;
     forth->pc = (uint8_t*) forth->debug_words.abt;
+    return KF_STATUS_OK;
+}
 
-    kfBiosPrintIsize(forth->here - forth->mem);
-    kfBiosWriteStr(" bytes used of ");
-    kfBiosPrintIsize(sizeof(forth->mem));
-    kfBiosCR();
+kfStatus kopForthInit(kopForth* forth) {
+    return kopForthInitSized(forth, KF_MEM_SIZE);
+}
+
+// Initializes the system from an image made by SAVE-IMAGE instead of building
+// the dictionary. The image has to come from the same build of kopForth.
+kfStatus kopForthLoadImage(kopForth* forth, char* name) {
+    usize len = 0;
+    while (name[len])
+        len++;
+    KF_RETURN_IF_ERROR(kfInitSystem(forth, KF_MEM_SIZE));
+    kfStatus s = kfImageLoad(forth, name, len);
+    if (!kfStatusIsOk(s)) {
+        kopForthFree(forth);
+        return s;
+    }
+    forth->pc = (uint8_t*) forth->debug_words.abt;
+    return KF_STATUS_OK;
+}
 
+// Initializes `clone` to share the dictionary of `parent` instead of building
+// or loading its own. The parent's dictionary becomes the clone's kernel, and
+// the clone gets its own stacks, input buffer, variables, and `mem` for the
+// words it defines. Clones can be cloned too.
+// Nothing in the parent's dictionary gets copied, so the parent (and its
+// parents) can't define words or be freed while it has clones, and any data
+// that was allotted in its dictionary is shared by all of them.
+// The clone gets as much room for words as the parent has.
+kfStatus kopForthClone(kopForth* parent, kopForth* clone) {
+    KF_RETURN_IF_ERROR(kfInitSystem(clone, parent->mem_size));
+    clone->kernel = parent->mem;
+    clone->kernel_size = parent->here - parent->mem;
+    clone->parent = parent;
+
+    clone->latest = parent->latest;
+    clone->pending = parent->latest;
+    clone->base = parent->base;
+    clone->debug_words = parent->debug_words;
+    for (usize i = 0; i < KF_FUSE_RULES; i++)
+        clone->fuse_rules[i] = parent->fuse_rules[i];
+    for (usize i = 0; i < KF_FOLD_RULES; i++)
+        clone->fold_rules[i] = parent->fold_rules[i];
+    clone->pc = (uint8_t*) clone->debug_words.abt;
     return KF_STATUS_OK;
 }
 
@@ -205,18 +741,91 @@ kfStatus kopForthTick(kopForth* forth) {
     if (forth->debug) {
         kfDebug(forth);
     }
-    kfWord* cur_word = (kfWord*) forth->pc;
-    if (cur_word->flags.bit_flags.is_native) {
-        KF_RETURN_IF_ERROR(cur_word->word_def.native(forth));
-        KF_RETURN_IF_ERROR(kfRetnStackPop(&forth->r_stack, (void**) &forth->pc));
+    return kfStep(forth);
+}
+
+// Runs up to `budget` words, or until a word returns a status other than OK.
+// The number of words that were run gets stored in `ticks` if it isn't NULL.
+// The debug flag is only checked once per call, so turning the debugger on or
+// off takes effect the next time this is called.
+kfStatus kopForthRun(kopForth* forth, usize budget, usize* ticks) {
+    kfStatus s = KF_STATUS_OK;
+    usize n = 0;
+    if (forth->debug) {
+        while (n < budget && kfStatusIsOk(s)) {
+            kfDebug(forth);
+            s = kfStep(forth);
+            n++;
+        }
     } else {
-        forth->pc = (uint8_t*) cur_word->word_def.forth;
+        #ifdef KF_DIRECT_THREADED
+            s = kfRunDirect(forth, budget, &n);
+        #else
+            while (n < budget && kfStatusIsOk(s)) {
+                s = kfStep(forth);
+                n++;
+            }
+        #endif
     }
-    KF_RETURN_IF_ERROR(kfRetnStackPush(&forth->r_stack, forth->pc + sizeof(kfWord*)));
-    forth->pc = *(uint8_t**) forth->pc;
-    return KF_STATUS_OK;
+    if (ticks != NULL)
+        *ticks = n;
+    return s;
+}
+
+// Interprets the `len` characters at `text` like EVALUATE does, without copying
+// them, and returns once they've been interpreted. It can be called between
+// calls to kopForthRun, and the system then carries on where it was, with
+// whatever the text left on the data stack. If the text has an error that
+// would go back to QUIT, KF_SYSTEM_ABORTED is returned instead, and the system
+// is put back how it was before the call: interpreting, with nothing half
+// compiled, and the data stack it had.
+kfStatus kopForthEvaluate(kopForth* forth, char* text, usize len) {
+    uint8_t* pc = forth->pc;
+    kfDataStack d_stack = forth->d_stack;
+    kfRetnStack r_stack = forth->r_stack;
+    usize source_depth = forth->source_depth;
+    bool host_eval = forth->host_eval;
+    kfWord* host = forth->host;
+
+    // Run EVALUATE with (EVALUATE-DONE) as the word after it, which stops the
+    // system once EVALUATE returns into it. If either stack is too full for
+    // that, the caller gets it back as it was.
+    kfStatus s = kfDataStackPush(&forth->d_stack, (isize) text);
+    if (kfStatusIsOk(s))
+        s = kfDataStackPush(&forth->d_stack, (isize) len);
+    if (kfStatusIsOk(s))
+        s = kfRetnStackPush(&forth->r_stack, &forth->host);
+    if (!kfStatusIsOk(s)) {
+        forth->d_stack = d_stack;
+        forth->r_stack = r_stack;
+        return s;
+    }
+    forth->host = forth->debug_words.evd;
+    forth->pc = (uint8_t*) forth->debug_words.evl;
+    forth->host_eval = true;
+    do {
+        s = kopForthRun(forth, 1000, NULL);
+    } while (kfStatusIsOk(s));
+
+    while (forth->source_depth > source_depth)
+        kfSourcePop(forth);
+    // ABORT never got to QUIT, which is what would stop compiling, and it
+    // cleared the caller's data stack along with the text's.
+    if (s != KF_SYSTEM_EVALUATED) {
+        forth->state = false;
+        forth->cpl_last = NULL;
+        forth->cpl_lits = NULL;
+        forth->cpl_tail = NULL;
+        forth->d_stack = d_stack;
+    }
+    forth->host = host;
+    forth->host_eval = host_eval;
+    forth->r_stack = r_stack;
+    forth->pc = pc;
+    return s == KF_SYSTEM_EVALUATED ? KF_STATUS_OK : s;
 }
 
+
 /* Program execution example 1
 
 0x0000: "lit"  n:1
@@ -1,6 +1,8 @@
 /*
- * main.c (last modified 2025-06-11)
+ * main.c (last modified 2026-10-17)
  * This is just a demo of how kopForth system is included.
+ * Pass the name of a file made by SAVE-IMAGE to start from it instead of
+ * building the dictionary from scratch.
  */
 
 #include <stdio.h>
@@ -11,37 +13,43 @@
 
 
 
-int main() {
+int main(int argc, char** argv) {
     // Initialize the metal and run self checks.
     kfBiosSetup();
     kfStatus s = kopForthTest();
     if (!kfStatusIsOk(s)) {
-        printf("Error: %d (%s)\n", s, kfStatusStr[s]);
         kfBiosTeardown();
+        printf("Error: %d (%s)\n", s, kfStatusStr[s]);
         return s;
     }
 
     // Initialize the kopForth system and make sure it succeeded.
     kopForth forth;
-    s = kopForthInit(&forth);
+    if (argc > 1)
+        s = kopForthLoadImage(&forth, argv[1]);
+    else
+        s = kopForthInit(&forth);
     if (!kfStatusIsOk(s)) {
-        printf("Error: %d (%s)\n", s, kfStatusStr[s]);
         kfBiosTeardown();
+        printf("Error: %d (%s)\n", s, kfStatusStr[s]);
         return s;
     }
+    kfPrintMemUsage(&forth);
 
-    // Run the kopForth system until it stops.
+    // Run the kopForth system until it stops, 1000 words at a time.
     do {
-        s = kopForthTick(&forth);
+        s = kopForthRun(&forth, 1000, NULL);
     } while (kfStatusIsOk(s));
 
     // Print debug stuff.
-    printf("\nstack: ");
+    kfBiosWriteStr("\nstack: ");
     kfDataStackPrint(&forth.d_stack);
-    printf("\ntib: %s\n", forth.tib);
-    printf("#tib: %d\n", (int) forth.tib_len);
+    kfBiosFlush();
+    printf("\nsource: %.*s\n", (int) forth.source_len, forth.source);
+    printf(">in: %d\n", (int) forth.in_offset);
 
     // Make sure it exited successfully.
+    kopForthFree(&forth);
     kfBiosTeardown();
     if (s != KF_SYSTEM_DONE) {
         printf("Error: %d (%s)\n", s, kfStatusStr[s]);